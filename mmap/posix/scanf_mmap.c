@@ -0,0 +1,151 @@
+/*
+
+scanf implementation -- memory-mapped file scanning for POSIX
+Copyright (C) 2021 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+/* posix_madvise */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../scanf.h"
+#include "scanf_mmap.h"
+
+struct scanf_mmap *scanf_mmap_open(const char *path) {
+    struct scanf_mmap *m;
+    struct stat st;
+    long page = sysconf(_SC_PAGESIZE);
+    int fd;
+    /* a window that is not whole pages would map the same range again */
+    if (page <= 0 || !SCANF_MMAP_WINDOW || SCANF_MMAP_WINDOW % page) {
+        errno = EINVAL;
+        return NULL;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st)
+            || !(m = (struct scanf_mmap *)malloc(sizeof(struct scanf_mmap)))) {
+        close(fd);
+        return NULL;
+    }
+    m->fd = fd;
+    m->size = st.st_size;
+    m->pos = m->cur = 0;
+    m->curlen = 0;
+    m->map = NULL;
+    m->mapoff = 0;
+    m->maplen = 0;
+    m->err = 0;
+    return m;
+}
+
+static void scanf_mmap_unmap_(struct scanf_mmap *m) {
+    if (m->map) {
+        munmap(m->map, m->maplen);
+        m->map = NULL;
+    }
+}
+
+void scanf_mmap_close(struct scanf_mmap *m) {
+    if (m) {
+        scanf_mmap_unmap_(m);
+        close(m->fd);
+        free(m);
+    }
+}
+
+/* the window handed out last has been consumed; hand out the rest of the
+   current mapping, mapping the next part of the file if it has run out */
+static size_t scanf_mmap_refill_(const char **buf, void *data) {
+    struct scanf_mmap *m = (struct scanf_mmap *)data;
+    m->pos = m->cur + m->curlen;
+    m->cur = m->pos;
+    m->curlen = 0;
+    if (m->pos >= m->size)
+        return 0;
+    if (!m->map || m->pos >= m->mapoff + (off_t)m->maplen) {
+        off_t off = m->pos - m->pos % sysconf(_SC_PAGESIZE);
+        size_t len = SCANF_MMAP_WINDOW;
+        void *p;
+        if ((off_t)len > m->size - off)
+            len = (size_t)(m->size - off);
+        scanf_mmap_unmap_(m);
+        p = mmap(NULL, len, PROT_READ, MAP_PRIVATE, m->fd, off);
+        if (p == MAP_FAILED) {
+            /* this looks like the end of the input to scanf, so
+               vscanf_mmap_next has to tell them apart */
+            m->err = errno;
+            return 0;
+        }
+        posix_madvise(p, len, POSIX_MADV_SEQUENTIAL);
+        m->map = (char *)p;
+        m->mapoff = off;
+        m->maplen = len;
+    }
+    *buf = m->map + (m->pos - m->mapoff);
+    m->curlen = (size_t)(m->mapoff + (off_t)m->maplen - m->pos);
+    return m->curlen;
+}
+
+static void scanf_mmap_consume_(size_t n, void *data) {
+    struct scanf_mmap *m = (struct scanf_mmap *)data;
+    m->pos = m->cur + (off_t)n;
+    m->cur = m->pos;
+    m->curlen = 0;
+}
+
+int vscanf_mmap_next(struct scanf_mmap *m, const char *format, va_list arg) {
+    int r;
+    if (m->err) {
+        errno = m->err;
+        return SCANF_MMAP_ERROR;
+    }
+    if (m->pos >= m->size)
+        return EOF;
+    r = vbufscanf_(&scanf_mmap_refill_, &scanf_mmap_consume_, m,
+                   format, arg);
+    if (m->err) {
+        errno = m->err;
+        return SCANF_MMAP_ERROR;
+    }
+    return r;
+}
+
+int scanf_mmap_next(struct scanf_mmap *m, const char *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vscanf_mmap_next(m, format, va);
+    va_end(va);
+    return r;
+}
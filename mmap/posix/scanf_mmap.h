@@ -0,0 +1,85 @@
+/*
+
+scanf implementation -- memory-mapped file scanning for POSIX
+Copyright (C) 2021 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#ifndef SCANF_MMAP_H
+#define SCANF_MMAP_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef __GNUC__
+#define ATTR_scanf_mmap_next  __attribute__ ((format (__scanf__, 2, 3)))
+#define ATTR_vscanf_mmap_next __attribute__ ((format (__scanf__, 2, 0)))
+#else
+#define ATTR_scanf_mmap_next
+#define ATTR_vscanf_mmap_next
+#endif
+
+/* how much of the file is mapped at a time. must be a multiple of the
+   page size, or scanf_mmap_open fails with EINVAL */
+#ifndef SCANF_MMAP_WINDOW
+#define SCANF_MMAP_WINDOW ((size_t)64 << 20)
+#endif
+
+/* returned by scanf_mmap_next if the file could not be mapped */
+#define SCANF_MMAP_ERROR (EOF - 1)
+
+struct scanf_mmap {
+    int fd;
+    /* size of the file */
+    off_t size;
+    /* file offset of the first unconsumed character */
+    off_t pos;
+    /* file offset and length of the part handed to scanf */
+    off_t cur;
+    size_t curlen;
+    /* current mapping, or NULL if none */
+    char *map;
+    off_t mapoff;
+    size_t maplen;
+    /* errno of the mapping that failed, or 0 */
+    int err;
+};
+
+struct scanf_mmap *scanf_mmap_open(const char *path);
+void scanf_mmap_close(struct scanf_mmap *m);
+
+ATTR_scanf_mmap_next int scanf_mmap_next(struct scanf_mmap *m,
+                                         const char *format, ...);
+ATTR_vscanf_mmap_next int vscanf_mmap_next(struct scanf_mmap *m,
+                                           const char *format, va_list arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCANF_MMAP_H */
@@ -125,6 +125,28 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #endif
 #endif
 
+/* for functions that sit in the hot loop of the interpreter */
+#ifndef ALWAYS_INLINE
+#if defined(__GNUC__)
+#define ALWAYS_INLINE __inline__ __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define ALWAYS_INLINE __forceinline
+#else
+#define ALWAYS_INLINE INLINE
+#endif
+#endif
+
+/* to keep rarely needed code out of the interpreter */
+#ifndef NOINLINE
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE
+#endif
+#endif
+
 /* boolean type */
 #ifndef BOOL
 #if defined(__cplusplus)
@@ -171,19 +193,134 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #endif
 
 #ifndef SCANF_FAST_SCANSET
-#if CHAR_BIT == 8
 #define SCANF_FAST_SCANSET 1
+#endif
+
+#undef SCANF_CAN_FAST_SCANSET
+#define SCANF_CAN_FAST_SCANSET SCANF_FAST_SCANSET
+
+/* fast scansets only have a bitmap for the first 256 characters; any others
+   are looked up from the format */
+#undef SCANF_SCANSET_HIGH
+#if SCANF_WIDE || UCHAR_MAX > 255
+#define SCANF_SCANSET_HIGH 1
 #else
-#define SCANF_FAST_SCANSET 0
+#define SCANF_SCANSET_HIGH 0
 #endif
+
+/* number of formats cached per thread, 0 to disable the cache */
+#ifndef SCANF_FORMAT_CACHE
+#define SCANF_FORMAT_CACHE 0
 #endif
 
-/* fast scanset only supported with multibyte/narrow characters */
-#undef SCANF_CAN_FAST_SCANSET
-#if SCANF_WIDE
-#define SCANF_CAN_FAST_SCANSET 0
+#if SCANF_FORMAT_CACHE
+/* maximum length of a cached format, including the null terminator */
+#ifndef SCANF_FORMAT_CACHE_LENGTH
+#define SCANF_FORMAT_CACHE_LENGTH 128
+#endif
+
+/* space for the compiled program of each cached format, in bytes */
+#ifndef SCANF_FORMAT_CACHE_BYTES
+#define SCANF_FORMAT_CACHE_BYTES 1024
+#endif
+#endif /* SCANF_FORMAT_CACHE */
+
+/* storage class of the format cache and the %m allocator */
+#ifndef SCANF_THREAD_LOCAL
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define SCANF_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L \
+    && !defined(__STDC_NO_THREADS__)
+#define SCANF_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define SCANF_THREAD_LOCAL __thread
+#elif defined(_MSC_VER)
+#define SCANF_THREAD_LOCAL __declspec(thread)
+#elif SCANF_FORMAT_CACHE
+#error SCANF_FORMAT_CACHE requires SCANF_THREAD_LOCAL to be defined
 #else
-#define SCANF_CAN_FAST_SCANSET SCANF_FAST_SCANSET
+/* there is only the %m allocator, which is then shared by all threads */
+#define SCANF_THREAD_LOCAL
+#endif
+#endif
+
+/* %ms, %m[ and %mc, which allocate the memory they store into. off by
+   default, as it uses malloc and static (thread-local) storage */
+#ifndef SCANF_ALLOC
+#define SCANF_ALLOC 0
+#endif
+
+/* %y and %y[ for interning strings into a dictionary, storing their IDs */
+#ifndef SCANF_INTERN
+#define SCANF_INTERN 1
+#endif
+
+/* %{...}e for reading one of a list of keywords, storing its index */
+#ifndef SCANF_KEYWORDS
+#define SCANF_KEYWORDS 1
+#endif
+
+/* %Us, %U[, %Qs and %Q[ for decoding URL and backslash escapes */
+#ifndef SCANF_DECODE
+#define SCANF_DECODE 1
+#endif
+
+/* SIMD kernels for long runs of characters. only x86 SSE2 (and SSSE3) for now,
+   and only with narrow characters */
+#ifndef SCANF_SIMD
+#if !SCANF_FREESTANDING && ((defined(__GNUC__) && defined(__SSE2__))          \
+    || (defined(_MSC_VER) && (defined(_M_X64)                                  \
+        || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))))
+#define SCANF_SIMD 1
+#else
+#define SCANF_SIMD 0
+#endif
+#endif
+
+/* SWAR (SIMD within a register) kernels that convert integers 8 digits at
+   a time with plain 64-bit arithmetic */
+#ifndef SCANF_SWAR
+#define SCANF_SWAR 1
+#endif
+
+/* correctly rounded decimal and hex floats (see the float engine below) */
+#ifndef SCANF_EXACT_FLOAT
+#define SCANF_EXACT_FLOAT 1
+#endif
+
+/* %Hf and %Bf for binary16 and bfloat16 (see the float engine below) */
+#ifndef SCANF_FLOAT16
+#define SCANF_FLOAT16 1
+#endif
+
+/* %w128d etc. for __int128, where the compiler has it */
+#ifndef SCANF_INT128
+#define SCANF_INT128 1
+#endif
+
+/* %.2D etc. for fixed-point decimals, scaled to integers */
+#ifndef SCANF_FIXED_POINT
+#define SCANF_FIXED_POINT 1
+#endif
+
+/* the ' flag for numbers with digit group separators, like 1,234,567 */
+#ifndef SCANF_GROUPING
+#define SCANF_GROUPING 1
+#endif
+
+/* the digit group separator for the ' flag */
+#ifndef SCANF_GROUPING_SEP
+#define SCANF_GROUPING_SEP ','
+#endif
+
+/* %v and %v[ for views of strings in the input, without copying them */
+#ifndef SCANF_VIEW
+#define SCANF_VIEW 1
+#endif
+
+/* %k, %k[ and %kc for streaming strings in the input to a callback */
+#ifndef SCANF_SINK
+#define SCANF_SINK 1
 #endif
 
 #ifndef SCANF_NOPOW
@@ -229,6 +366,41 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #endif
 #endif
 
+#if SCANF_ALLOC && !SCANF_FREESTANDING
+#include <stdlib.h>
+#endif
+
+#undef SCANF_USE_SIMD
+#if SCANF_SIMD && SCANF_ASCII && !SCANF_WIDE
+#define SCANF_USE_SIMD 1
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if !defined(__GNUC__)
+#include <intrin.h>
+#endif
+#else
+#define SCANF_USE_SIMD 0
+#endif
+
+/* the SWAR kernels work on uintmax_t, which must then have exactly 64 bits */
+#undef SCANF_USE_SWAR
+#if SCANF_SWAR && SCANF_ASCII && !SCANF_WIDE                                   \
+    && UINTMAX_MAX / 0xFFFFFFFFUL / 0xFFFFFFFFUL == 1
+#define SCANF_USE_SWAR 1
+#else
+#define SCANF_USE_SWAR 0
+#endif
+
+/* digits are looked up from a table instead of going through ctorn_ */
+#undef SCANF_USE_DTABLE
+#if SCANF_ASCII && !SCANF_MINIMIZE
+#define SCANF_USE_DTABLE 1
+#else
+#define SCANF_USE_DTABLE 0
+#endif
+
 /* type & literal defines */
 #undef C_
 #undef S_
@@ -236,6 +408,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #undef CHAR
 #undef UCHAR
 #undef CINT
+#undef GSEP_
 
 #if SCANF_WIDE
 /* character */
@@ -267,6 +440,11 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define CINT int
 #endif
 
+#if SCANF_GROUPING
+/* the digit group separator, as read from the input */
+#define GSEP_ ((CINT)(UCHAR)SCANF_GROUPING_SEP)
+#endif
+
 #if !SCANF_DISABLE_SUPPORT_FLOAT
 #include <float.h>
 #endif
@@ -387,12 +565,64 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
                   && DBL_MAX_EXP == LDBL_MAX_EXP
 #define LDOUBLE_IS_DOUBLE 1
 #endif
+
+/* the float engine assembles IEEE 754 binary32 floats and binary64 doubles
+   bit by bit in an unsigned int and a 64-bit uintmax_t */
+#undef SCANF_USE_EXACT_FLOAT
+#if SCANF_EXACT_FLOAT && FLT_RADIX == 2 && DBL_MANT_DIG == 53                  \
+    && DBL_MIN_EXP == -1021 && DBL_MAX_EXP == 1024 && FLT_MANT_DIG == 24       \
+    && FLT_MIN_EXP == -125 && FLT_MAX_EXP == 128 && UINT_MAX == 0xFFFFFFFFUL   \
+    && UINTMAX_MAX / 0xFFFFFFFFUL / 0xFFFFFFFFUL == 1
+#define SCANF_USE_EXACT_FLOAT 1
+#else
+#define SCANF_USE_EXACT_FLOAT 0
+#endif
+
+/* 16-bit floats are only rounded by the float engine, and stored as their
+   bits in an unsigned short */
+#undef SCANF_USE_FLOAT16
+#if SCANF_FLOAT16 && SCANF_USE_EXACT_FLOAT && !SCANF_DISABLE_SUPPORT_FLOAT    \
+    && USHRT_MAX == 0xFFFFU
+#define SCANF_USE_FLOAT16 1
+#else
+#define SCANF_USE_FLOAT16 0
+#endif
+
+/* 128-bit integers are converted in chunks that fit in a 64-bit uintmax_t */
+#undef SCANF_USE_INT128
+#if SCANF_INT128 && defined(__SIZEOF_INT128__)                                \
+    && UINTMAX_MAX / 0xFFFFFFFFUL / 0xFFFFFFFFUL == 1
+#define SCANF_USE_INT128 1
+#else
+#define SCANF_USE_INT128 0
+#endif
+
+/* dictionaries take their memory from the %m allocator */
+#undef SCANF_USE_INTERN
+#if SCANF_INTERN && SCANF_ALLOC
+#define SCANF_USE_INTERN 1
+#else
+#define SCANF_USE_INTERN 0
+#endif
+
+/* whether float and double arithmetic is done in the precision of the type
+   (and not e.g. on the x87 stack), so that one operation is correctly
+   rounded */
+#undef SCANF_EXACT_EVAL
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0)                         \
+    || (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ == 0)
+#define SCANF_EXACT_EVAL 1
+#else
+#define SCANF_EXACT_EVAL 0
+#endif
 #endif
 
 #ifdef UINTPTR_MAX
 #define INT_TO_PTR(x) ((void*)(uintptr_t)(uintmax_t)(x))
+#define PTR_TO_INT(p) ((uintmax_t)(uintptr_t)(p))
 #else
 #define INT_TO_PTR(x) ((void*)(uintmax_t)(x))
+#define PTR_TO_INT(p) ((uintmax_t)(p))
 #endif
 
 #if SCANF_CLAMP
@@ -431,6 +661,8 @@ static INLINE_IF_ASCII int F_(ctodn_)(CINT c) {
 #endif
 }
 
+/* only floats use these when there is a digit table */
+#if !SCANF_USE_DTABLE || !SCANF_DISABLE_SUPPORT_FLOAT
 static INLINE_IF_ASCII int F_(ctoon_)(CINT c) {
 #if SCANF_ASCII
     return c - C_('0');
@@ -507,6 +739,7 @@ static int F_(ctorn_)(CINT c, int b) {
         return F_(ctodn_)(c);
     }
 }
+#endif /* !SCANF_USE_DTABLE || !SCANF_DISABLE_SUPPORT_FLOAT */
 
 /* =============================== *
  *         character checks        *
@@ -602,6 +835,7 @@ static INLINE int F_(isalnum)(CINT c) {
 #endif
 #endif
 
+#if !SCANF_USE_DTABLE || !SCANF_DISABLE_SUPPORT_FLOAT
 static INLINE int F_(isdigo_)(CINT c) {
 #if SCANF_ASCII
     return C_('0') <= c && c <= C_('7');
@@ -639,6 +873,47 @@ static INLINE int F_(isdigr_)(CINT c, int b) {
         return F_(isdigit)(c);
     }
 }
+#endif /* !SCANF_USE_DTABLE || !SCANF_DISABLE_SUPPORT_FLOAT */
+
+#if SCANF_USE_DTABLE
+#ifndef SCANF_REPEAT
+#define XX 0xFF
+/* the value of every character as a digit (up to base 36), XX if none */
+static const unsigned char dvals_[256] = {
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, XX, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    XX, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX,
+    XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX, XX
+};
+#undef XX
+#endif /* SCANF_REPEAT */
+#endif /* SCANF_USE_DTABLE */
+
+/* value of c as a digit in base b, or b or more if it is not one */
+static INLINE int F_(ctovn_)(CINT c, int b) {
+#if SCANF_USE_DTABLE
+#if SCANF_WIDE || UCHAR_MAX > 255
+    return c > 255 ? b : dvals_[c];
+#else
+    (void)b;
+    return dvals_[c];
+#endif
+#else
+    return F_(isdigr_)(c, b) ? F_(ctorn_)(c, b) : b;
+#endif
+}
 
 /* =============================== *
  *          integer  math          *
@@ -686,6 +961,1064 @@ static floatmax_t powi_(floatmax_t x, intmax_t y) {
 }
 #endif
 
+#if SCANF_USE_EXACT_FLOAT
+/* the float engine converts decimal digits to correctly rounded (round half
+   to even) binary floats. most numbers take Clinger's fast path or the
+   Eisel-Lemire algorithm; the few that are too close to a halfway point to
+   tell from their first 19 digits are converted exactly digit by digit.
+   hex floats are simpler, since their digits are already bits */
+
+/* an IEEE 754 binary format */
+struct ffmt_ {
+    int mbits;          /* mantissa bits, without the implicit one */
+    int ebits;          /* exponent bits */
+    int evenlo, evenhi; /* range of q in w * 10^q where there can be ties */
+};
+
+static const struct ffmt_ fbin32_ = { 23, 8, -17, 10 };
+static const struct ffmt_ fbin64_ = { 52, 11, -4, 23 };
+#if SCANF_USE_FLOAT16
+static const struct ffmt_ fbin16_ = { 10, 5, -22, 5 };
+static const struct ffmt_ fbf16_ = { 7, 8, -24, 3 };
+#endif
+
+/* 5^q for FPOW5_MIN <= q <= FPOW5_MAX as 128-bit fractions, high half first.
+   negative powers are rounded up, positive ones truncated */
+#define FPOW5_MIN -342
+#define FPOW5_MAX 308
+static const uintmax_t fpow5_[FPOW5_MAX - FPOW5_MIN + 1][2] = {
+    { 0xEEF453D6923BD65A, 0x113FAA2906A13B3F },
+    { 0x9558B4661B6565F8, 0x4AC7CA59A424C507 },
+    { 0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649 },
+    { 0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC },
+    { 0x91D8A02BB6C10594, 0x79071B9B8A4BE869 },
+    { 0xB64EC836A47146F9, 0x9748E2826CDEE284 },
+    { 0xE3E27A444D8D98B7, 0xFD1B1B2308169B25 },
+    { 0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7 },
+    { 0xB208EF855C969F4F, 0xBDBD2D335E51A935 },
+    { 0xDE8B2B66B3BC4723, 0xAD2C788035E61382 },
+    { 0x8B16FB203055AC76, 0x4C3BCB5021AFCC31 },
+    { 0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D },
+    { 0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D },
+    { 0x87D4713D6F33AA6B, 0x8672648C40E5AD68 },
+    { 0xA9C98D8CCB009506, 0x680EFDAF511F18C2 },
+    { 0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2 },
+    { 0x84A57695FE98746D, 0x014BB630F7604B57 },
+    { 0xA5CED43B7E3E9188, 0x419EA3BD35385E2D },
+    { 0xCF42894A5DCE35EA, 0x52064CAC828675B9 },
+    { 0x818995CE7AA0E1B2, 0x7343EFEBD1940993 },
+    { 0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8 },
+    { 0xCA66FA129F9B60A6, 0xD41A26E077774EF6 },
+    { 0xFD00B897478238D0, 0x8920B098955522B4 },
+    { 0x9E20735E8CB16382, 0x55B46E5F5D5535B0 },
+    { 0xC5A890362FDDBC62, 0xEB2189F734AA831D },
+    { 0xF712B443BBD52B7B, 0xA5E9EC7501D523E4 },
+    { 0x9A6BB0AA55653B2D, 0x47B233C92125366E },
+    { 0xC1069CD4EABE89F8, 0x999EC0BB696E840A },
+    { 0xF148440A256E2C76, 0xC00670EA43CA250D },
+    { 0x96CD2A865764DBCA, 0x380406926A5E5728 },
+    { 0xBC807527ED3E12BC, 0xC605083704F5ECF2 },
+    { 0xEBA09271E88D976B, 0xF7864A44C633682E },
+    { 0x93445B8731587EA3, 0x7AB3EE6AFBE0211D },
+    { 0xB8157268FDAE9E4C, 0x5960EA05BAD82964 },
+    { 0xE61ACF033D1A45DF, 0x6FB92487298E33BD },
+    { 0x8FD0C16206306BAB, 0xA5D3B6D479F8E056 },
+    { 0xB3C4F1BA87BC8696, 0x8F48A4899877186C },
+    { 0xE0B62E2929ABA83C, 0x331ACDABFE94DE87 },
+    { 0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14 },
+    { 0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9 },
+    { 0xDB71E91432B1A24A, 0xC9E82CD9F69D6150 },
+    { 0x892731AC9FAF056E, 0xBE311C083A225CD2 },
+    { 0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406 },
+    { 0xD64D3D9DB981787D, 0x092CBBCCDAD5B108 },
+    { 0x85F0468293F0EB4E, 0x25BBF56008C58EA5 },
+    { 0xA76C582338ED2621, 0xAF2AF2B80AF6F24E },
+    { 0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1 },
+    { 0x82CCA4DB847945CA, 0x50D98D9FC890ED4D },
+    { 0xA37FCE126597973C, 0xE50FF107BAB528A0 },
+    { 0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8 },
+    { 0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A },
+    { 0x9FAACF3DF73609B1, 0x77B191618C54E9AC },
+    { 0xC795830D75038C1D, 0xD59DF5B9EF6A2417 },
+    { 0xF97AE3D0D2446F25, 0x4B0573286B44AD1D },
+    { 0x9BECCE62836AC577, 0x4EE367F9430AEC32 },
+    { 0xC2E801FB244576D5, 0x229C41F793CDA73F },
+    { 0xF3A20279ED56D48A, 0x6B43527578C1110F },
+    { 0x9845418C345644D6, 0x830A13896B78AAA9 },
+    { 0xBE5691EF416BD60C, 0x23CC986BC656D553 },
+    { 0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8 },
+    { 0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9 },
+    { 0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53 },
+    { 0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68 },
+    { 0x91376C36D99995BE, 0x23100809B9C21FA1 },
+    { 0xB58547448FFFFB2D, 0xABD40A0C2832A78A },
+    { 0xE2E69915B3FFF9F9, 0x16C90C8F323F516C },
+    { 0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3 },
+    { 0xB1442798F49FFB4A, 0x99CD11CFDF41779C },
+    { 0xDD95317F31C7FA1D, 0x40405643D711D583 },
+    { 0x8A7D3EEF7F1CFC52, 0x482835EA666B2572 },
+    { 0xAD1C8EAB5EE43B66, 0xDA3243650005EECF },
+    { 0xD863B256369D4A40, 0x90BED43E40076A82 },
+    { 0x873E4F75E2224E68, 0x5A7744A6E804A291 },
+    { 0xA90DE3535AAAE202, 0x711515D0A205CB36 },
+    { 0xD3515C2831559A83, 0x0D5A5B44CA873E03 },
+    { 0x8412D9991ED58091, 0xE858790AFE9486C2 },
+    { 0xA5178FFF668AE0B6, 0x626E974DBE39A872 },
+    { 0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F },
+    { 0x80FA687F881C7F8E, 0x7CE66634BC9D0B99 },
+    { 0xA139029F6A239F72, 0x1C1FFFC1EBC44E80 },
+    { 0xC987434744AC874E, 0xA327FFB266B56220 },
+    { 0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8 },
+    { 0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9 },
+    { 0xC4CE17B399107C22, 0xCB550FB4384D21D3 },
+    { 0xF6019DA07F549B2B, 0x7E2A53A146606A48 },
+    { 0x99C102844F94E0FB, 0x2EDA7444CBFC426D },
+    { 0xC0314325637A1939, 0xFA911155FEFB5308 },
+    { 0xF03D93EEBC589F88, 0x793555AB7EBA27CA },
+    { 0x96267C7535B763B5, 0x4BC1558B2F3458DE },
+    { 0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16 },
+    { 0xEA9C227723EE8BCB, 0x465E15A979C1CADC },
+    { 0x92A1958A7675175F, 0x0BFACD89EC191EC9 },
+    { 0xB749FAED14125D36, 0xCEF980EC671F667B },
+    { 0xE51C79A85916F484, 0x82B7E12780E7401A },
+    { 0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810 },
+    { 0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15 },
+    { 0xDFBDCECE67006AC9, 0x67A791E093E1D49A },
+    { 0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0 },
+    { 0xAECC49914078536D, 0x58FAE9F773886E18 },
+    { 0xDA7F5BF590966848, 0xAF39A475506A899E },
+    { 0x888F99797A5E012D, 0x6D8406C952429603 },
+    { 0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83 },
+    { 0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64 },
+    { 0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F },
+    { 0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E },
+    { 0xD0601D8EFC57B08B, 0xF13B94DAF124DA26 },
+    { 0x823C12795DB6CE57, 0x76C53D08D6B70858 },
+    { 0xA2CB1717B52481ED, 0x54768C4B0C64CA6E },
+    { 0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09 },
+    { 0xFE5D54150B090B02, 0xD3F93B35435D7C4C },
+    { 0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF },
+    { 0xC6B8E9B0709F109A, 0x359AB6419CA1091B },
+    { 0xF867241C8CC6D4C0, 0xC30163D203C94B62 },
+    { 0x9B407691D7FC44F8, 0x79E0DE63425DCF1D },
+    { 0xC21094364DFB5636, 0x985915FC12F542E4 },
+    { 0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D },
+    { 0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42 },
+    { 0xBD8430BD08277231, 0x50C6FF782A838353 },
+    { 0xECE53CEC4A314EBD, 0xA4F8BF5635246428 },
+    { 0x940F4613AE5ED136, 0x871B7795E136BE99 },
+    { 0xB913179899F68584, 0x28E2557B59846E3F },
+    { 0xE757DD7EC07426E5, 0x331AEADA2FE589CF },
+    { 0x9096EA6F3848984F, 0x3FF0D2C85DEF7621 },
+    { 0xB4BCA50B065ABE63, 0x0FED077A756B53A9 },
+    { 0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894 },
+    { 0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C },
+    { 0xB080392CC4349DEC, 0xBD8D794D96AACFB3 },
+    { 0xDCA04777F541C567, 0xECF0D7A0FC5583A0 },
+    { 0x89E42CAAF9491B60, 0xF41686C49DB57244 },
+    { 0xAC5D37D5B79B6239, 0x311C2875C522CED5 },
+    { 0xD77485CB25823AC7, 0x7D633293366B828B },
+    { 0x86A8D39EF77164BC, 0xAE5DFF9C02033197 },
+    { 0xA8530886B54DBDEB, 0xD9F57F830283FDFC },
+    { 0xD267CAA862A12D66, 0xD072DF63C324FD7B },
+    { 0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D },
+    { 0xA46116538D0DEB78, 0x52D9BE85F074E608 },
+    { 0xCD795BE870516656, 0x67902E276C921F8B },
+    { 0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6 },
+    { 0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4 },
+    { 0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD },
+    { 0xFAD2A4B13D1B5D6C, 0x796B805720085F81 },
+    { 0x9CC3A6EEC6311A63, 0xCBE3303674053BB0 },
+    { 0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C },
+    { 0xF4F1B4D515ACB93B, 0xEE92FB5515482D44 },
+    { 0x991711052D8BF3C5, 0x751BDD152D4D1C4A },
+    { 0xBF5CD54678EEF0B6, 0xD262D45A78A0635D },
+    { 0xEF340A98172AACE4, 0x86FB897116C87C34 },
+    { 0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0 },
+    { 0xBAE0A846D2195712, 0x8974836059CCA109 },
+    { 0xE998D258869FACD7, 0x2BD1A438703FC94B },
+    { 0x91FF83775423CC06, 0x7B6306A34627DDCF },
+    { 0xB67F6455292CBF08, 0x1A3BC84C17B1D542 },
+    { 0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93 },
+    { 0x8E938662882AF53E, 0x547EB47B7282EE9C },
+    { 0xB23867FB2A35B28D, 0xE99E619A4F23AA43 },
+    { 0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4 },
+    { 0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04 },
+    { 0xAE0B158B4738705E, 0x9624AB50B148D445 },
+    { 0xD98DDAEE19068C76, 0x3BADD624DD9B0957 },
+    { 0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6 },
+    { 0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C },
+    { 0xD47487CC8470652B, 0x7647C3200069671F },
+    { 0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073 },
+    { 0xA5FB0A17C777CF09, 0xF468107100525890 },
+    { 0xCF79CC9DB955C2CC, 0x7182148D4066EEB4 },
+    { 0x81AC1FE293D599BF, 0xC6F14CD848405530 },
+    { 0xA21727DB38CB002F, 0xB8ADA00E5A506A7C },
+    { 0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C },
+    { 0xFD442E4688BD304A, 0x908F4A166D1DA663 },
+    { 0x9E4A9CEC15763E2E, 0x9A598E4E043287FE },
+    { 0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD },
+    { 0xF7549530E188C128, 0xD12BEE59E68EF47C },
+    { 0x9A94DD3E8CF578B9, 0x82BB74F8301958CE },
+    { 0xC13A148E3032D6E7, 0xE36A52363C1FAF01 },
+    { 0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1 },
+    { 0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9 },
+    { 0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7 },
+    { 0xEBDF661791D60F56, 0x111B495B3464AD21 },
+    { 0x936B9FCEBB25C995, 0xCAB10DD900BEEC34 },
+    { 0xB84687C269EF3BFB, 0x3D5D514F40EEA742 },
+    { 0xE65829B3046B0AFA, 0x0CB4A5A3112A5112 },
+    { 0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB },
+    { 0xB3F4E093DB73A093, 0x59ED216765690F56 },
+    { 0xE0F218B8D25088B8, 0x306869C13EC3532C },
+    { 0x8C974F7383725573, 0x1E414218C73A13FB },
+    { 0xAFBD2350644EEACF, 0xE5D1929EF90898FA },
+    { 0xDBAC6C247D62A583, 0xDF45F746B74ABF39 },
+    { 0x894BC396CE5DA772, 0x6B8BBA8C328EB783 },
+    { 0xAB9EB47C81F5114F, 0x066EA92F3F326564 },
+    { 0xD686619BA27255A2, 0xC80A537B0EFEFEBD },
+    { 0x8613FD0145877585, 0xBD06742CE95F5F36 },
+    { 0xA798FC4196E952E7, 0x2C48113823B73704 },
+    { 0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5 },
+    { 0x82EF85133DE648C4, 0x9A984D73DBE722FB },
+    { 0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA },
+    { 0xCC963FEE10B7D1B3, 0x318DF905079926A8 },
+    { 0xFFBBCFE994E5C61F, 0xFDF17746497F7052 },
+    { 0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633 },
+    { 0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0 },
+    { 0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0 },
+    { 0x9C1661A651213E2D, 0x06BEA10CA65C084E },
+    { 0xC31BFA0FE5698DB8, 0x486E494FCFF30A62 },
+    { 0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA },
+    { 0x986DDB5C6B3A76B7, 0xF89629465A75E01C },
+    { 0xBE89523386091465, 0xF6BBB397F1135823 },
+    { 0xEE2BA6C0678B597F, 0x746AA07DED582E2C },
+    { 0x94DB483840B717EF, 0xA8C2A44EB4571CDC },
+    { 0xBA121A4650E4DDEB, 0x92F34D62616CE413 },
+    { 0xE896A0D7E51E1566, 0x77B020BAF9C81D17 },
+    { 0x915E2486EF32CD60, 0x0ACE1474DC1D122E },
+    { 0xB5B5ADA8AAFF80B8, 0x0D819992132456BA },
+    { 0xE3231912D5BF60E6, 0x10E1FFF697ED6C69 },
+    { 0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1 },
+    { 0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2 },
+    { 0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE },
+    { 0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B },
+    { 0xAD4AB7112EB3929D, 0x86C16C98D2C953C6 },
+    { 0xD89D64D57A607744, 0xE871C7BF077BA8B7 },
+    { 0x87625F056C7C4A8B, 0x11471CD764AD4972 },
+    { 0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF },
+    { 0xD389B47879823479, 0x4AFF1D108D4EC2C3 },
+    { 0x843610CB4BF160CB, 0xCEDF722A585139BA },
+    { 0xA54394FE1EEDB8FE, 0xC2974EB4EE658828 },
+    { 0xCE947A3DA6A9273E, 0x733D226229FEEA32 },
+    { 0x811CCC668829B887, 0x0806357D5A3F525F },
+    { 0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7 },
+    { 0xC9BCFF6034C13052, 0xFC89B393DD02F0B5 },
+    { 0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2 },
+    { 0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D },
+    { 0xC5029163F384A931, 0x0A9E795E65D4DF11 },
+    { 0xF64335BCF065D37D, 0x4D4617B5FF4A16D5 },
+    { 0x99EA0196163FA42E, 0x504BCED1BF8E4E45 },
+    { 0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6 },
+    { 0xF07DA27A82C37088, 0x5D767327BB4E5A4C },
+    { 0x964E858C91BA2655, 0x3A6A07F8D510F86F },
+    { 0xBBE226EFB628AFEA, 0x890489F70A55368B },
+    { 0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E },
+    { 0x92C8AE6B464FC96F, 0x3B0B8BC90012929D },
+    { 0xB77ADA0617E3BBCB, 0x09CE6EBB40173744 },
+    { 0xE55990879DDCAABD, 0xCC420A6A101D0515 },
+    { 0x8F57FA54C2A9EAB6, 0x9FA946824A12232D },
+    { 0xB32DF8E9F3546564, 0x47939822DC96ABF9 },
+    { 0xDFF9772470297EBD, 0x59787E2B93BC56F7 },
+    { 0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A },
+    { 0xAEFAE51477A06B03, 0xEDE622920B6B23F1 },
+    { 0xDAB99E59958885C4, 0xE95FAB368E45ECED },
+    { 0x88B402F7FD75539B, 0x11DBCB0218EBB414 },
+    { 0xAAE103B5FCD2A881, 0xD652BDC29F26A119 },
+    { 0xD59944A37C0752A2, 0x4BE76D3346F0495F },
+    { 0x857FCAE62D8493A5, 0x6F70A4400C562DDB },
+    { 0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952 },
+    { 0xD097AD07A71F26B2, 0x7E2000A41346A7A7 },
+    { 0x825ECC24C873782F, 0x8ED400668C0C28C8 },
+    { 0xA2F67F2DFA90563B, 0x728900802F0F32FA },
+    { 0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9 },
+    { 0xFEA126B7D78186BC, 0xE2F610C84987BFA8 },
+    { 0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9 },
+    { 0xC6EDE63FA05D3143, 0x91503D1C79720DBB },
+    { 0xF8A95FCF88747D94, 0x75A44C6397CE912A },
+    { 0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA },
+    { 0xC24452DA229B021B, 0xFBE85BADCE996168 },
+    { 0xF2D56790AB41C2A2, 0xFAE27299423FB9C3 },
+    { 0x97C560BA6B0919A5, 0xDCCD879FC967D41A },
+    { 0xBDB6B8E905CB600F, 0x5400E987BBC1C920 },
+    { 0xED246723473E3813, 0x290123E9AAB23B68 },
+    { 0x9436C0760C86E30B, 0xF9A0B6720AAF6521 },
+    { 0xB94470938FA89BCE, 0xF808E40E8D5B3E69 },
+    { 0xE7958CB87392C2C2, 0xB60B1D1230B20E04 },
+    { 0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2 },
+    { 0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3 },
+    { 0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0 },
+    { 0x8D590723948A535F, 0x579C487E5A38AD0E },
+    { 0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851 },
+    { 0xDCDB1B2798182244, 0xF8E431456CF88E65 },
+    { 0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF },
+    { 0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F },
+    { 0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F },
+    { 0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9 },
+    { 0xA87FEA27A539E9A5, 0x3F2398D747B36224 },
+    { 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD },
+    { 0x83A3EEEEF9153E89, 0x1953CF68300424AC },
+    { 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7 },
+    { 0xCDB02555653131B6, 0x3792F412CB06794D },
+    { 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0 },
+    { 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4 },
+    { 0xC8DE047564D20A8B, 0xF245825A5A445275 },
+    { 0xFB158592BE068D2E, 0xEED6E2F0F0D56712 },
+    { 0x9CED737BB6C4183D, 0x55464DD69685606B },
+    { 0xC428D05AA4751E4C, 0xAA97E14C3C26B886 },
+    { 0xF53304714D9265DF, 0xD53DD99F4B3066A8 },
+    { 0x993FE2C6D07B7FAB, 0xE546A8038EFE4029 },
+    { 0xBF8FDB78849A5F96, 0xDE98520472BDD033 },
+    { 0xEF73D256A5C0F77C, 0x963E66858F6D4440 },
+    { 0x95A8637627989AAD, 0xDDE7001379A44AA8 },
+    { 0xBB127C53B17EC159, 0x5560C018580D5D52 },
+    { 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6 },
+    { 0x9226712162AB070D, 0xCAB3961304CA70E8 },
+    { 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22 },
+    { 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A },
+    { 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242 },
+    { 0xB267ED1940F1C61C, 0x55F038B237591ED3 },
+    { 0xDF01E85F912E37A3, 0x6B6C46DEC52F6688 },
+    { 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015 },
+    { 0xAE397D8AA96C1B77, 0xABEC975E0A0D081A },
+    { 0xD9C7DCED53C72255, 0x96E7BD358C904A21 },
+    { 0x881CEA14545C7575, 0x7E50D64177DA2E54 },
+    { 0xAA242499697392D2, 0xDDE50BD1D5D0B9E9 },
+    { 0xD4AD2DBFC3D07787, 0x955E4EC64B44E864 },
+    { 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E },
+    { 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E },
+    { 0xCFB11EAD453994BA, 0x67DE18EDA5814AF2 },
+    { 0x81CEB32C4B43FCF4, 0x80EACF948770CED7 },
+    { 0xA2425FF75E14FC31, 0xA1258379A94D028D },
+    { 0xCAD2F7F5359A3B3E, 0x096EE45813A04330 },
+    { 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC },
+    { 0x9E74D1B791E07E48, 0x775EA264CF55347E },
+    { 0xC612062576589DDA, 0x95364AFE032A819E },
+    { 0xF79687AED3EEC551, 0x3A83DDBD83F52205 },
+    { 0x9ABE14CD44753B52, 0xC4926A9672793543 },
+    { 0xC16D9A0095928A27, 0x75B7053C0F178294 },
+    { 0xF1C90080BAF72CB1, 0x5324C68B12DD6339 },
+    { 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04 },
+    { 0xBCE5086492111AEA, 0x88F4BB1CA6BCF585 },
+    { 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6 },
+    { 0x9392EE8E921D5D07, 0x3AFF322E62439FD0 },
+    { 0xB877AA3236A4B449, 0x09BEFEB9FAD487C3 },
+    { 0xE69594BEC44DE15B, 0x4C2EBE687989A9B4 },
+    { 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11 },
+    { 0xB424DC35095CD80F, 0x538484C19EF38C95 },
+    { 0xE12E13424BB40E13, 0x2865A5F206B06FBA },
+    { 0x8CBCCC096F5088CB, 0xF93F87B7442E45D4 },
+    { 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749 },
+    { 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C },
+    { 0x89705F4136B4A597, 0x31680A88F8953031 },
+    { 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E },
+    { 0xD6BF94D5E57A42BC, 0x3D32907604691B4D },
+    { 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110 },
+    { 0xA7C5AC471B478423, 0x0FCF80DC33721D54 },
+    { 0xD1B71758E219652B, 0xD3C36113404EA4A9 },
+    { 0x83126E978D4FDF3B, 0x645A1CAC083126EA },
+    { 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4 },
+    { 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD },
+    { 0x8000000000000000, 0x0000000000000000 },
+    { 0xA000000000000000, 0x0000000000000000 },
+    { 0xC800000000000000, 0x0000000000000000 },
+    { 0xFA00000000000000, 0x0000000000000000 },
+    { 0x9C40000000000000, 0x0000000000000000 },
+    { 0xC350000000000000, 0x0000000000000000 },
+    { 0xF424000000000000, 0x0000000000000000 },
+    { 0x9896800000000000, 0x0000000000000000 },
+    { 0xBEBC200000000000, 0x0000000000000000 },
+    { 0xEE6B280000000000, 0x0000000000000000 },
+    { 0x9502F90000000000, 0x0000000000000000 },
+    { 0xBA43B74000000000, 0x0000000000000000 },
+    { 0xE8D4A51000000000, 0x0000000000000000 },
+    { 0x9184E72A00000000, 0x0000000000000000 },
+    { 0xB5E620F480000000, 0x0000000000000000 },
+    { 0xE35FA931A0000000, 0x0000000000000000 },
+    { 0x8E1BC9BF04000000, 0x0000000000000000 },
+    { 0xB1A2BC2EC5000000, 0x0000000000000000 },
+    { 0xDE0B6B3A76400000, 0x0000000000000000 },
+    { 0x8AC7230489E80000, 0x0000000000000000 },
+    { 0xAD78EBC5AC620000, 0x0000000000000000 },
+    { 0xD8D726B7177A8000, 0x0000000000000000 },
+    { 0x878678326EAC9000, 0x0000000000000000 },
+    { 0xA968163F0A57B400, 0x0000000000000000 },
+    { 0xD3C21BCECCEDA100, 0x0000000000000000 },
+    { 0x84595161401484A0, 0x0000000000000000 },
+    { 0xA56FA5B99019A5C8, 0x0000000000000000 },
+    { 0xCECB8F27F4200F3A, 0x0000000000000000 },
+    { 0x813F3978F8940984, 0x4000000000000000 },
+    { 0xA18F07D736B90BE5, 0x5000000000000000 },
+    { 0xC9F2C9CD04674EDE, 0xA400000000000000 },
+    { 0xFC6F7C4045812296, 0x4D00000000000000 },
+    { 0x9DC5ADA82B70B59D, 0xF020000000000000 },
+    { 0xC5371912364CE305, 0x6C28000000000000 },
+    { 0xF684DF56C3E01BC6, 0xC732000000000000 },
+    { 0x9A130B963A6C115C, 0x3C7F400000000000 },
+    { 0xC097CE7BC90715B3, 0x4B9F100000000000 },
+    { 0xF0BDC21ABB48DB20, 0x1E86D40000000000 },
+    { 0x96769950B50D88F4, 0x1314448000000000 },
+    { 0xBC143FA4E250EB31, 0x17D955A000000000 },
+    { 0xEB194F8E1AE525FD, 0x5DCFAB0800000000 },
+    { 0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000 },
+    { 0xB7ABC627050305AD, 0xF14A3D9E40000000 },
+    { 0xE596B7B0C643C719, 0x6D9CCD05D0000000 },
+    { 0x8F7E32CE7BEA5C6F, 0xE4820023A2000000 },
+    { 0xB35DBF821AE4F38B, 0xDDA2802C8A800000 },
+    { 0xE0352F62A19E306E, 0xD50B2037AD200000 },
+    { 0x8C213D9DA502DE45, 0x4526F422CC340000 },
+    { 0xAF298D050E4395D6, 0x9670B12B7F410000 },
+    { 0xDAF3F04651D47B4C, 0x3C0CDD765F114000 },
+    { 0x88D8762BF324CD0F, 0xA5880A69FB6AC800 },
+    { 0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00 },
+    { 0xD5D238A4ABE98068, 0x72A4904598D6D880 },
+    { 0x85A36366EB71F041, 0x47A6DA2B7F864750 },
+    { 0xA70C3C40A64E6C51, 0x999090B65F67D924 },
+    { 0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D },
+    { 0x82818F1281ED449F, 0xBFF8F10E7A8921A4 },
+    { 0xA321F2D7226895C7, 0xAFF72D52192B6A0D },
+    { 0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490 },
+    { 0xFEE50B7025C36A08, 0x02F236D04753D5B4 },
+    { 0x9F4F2726179A2245, 0x01D762422C946590 },
+    { 0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5 },
+    { 0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2 },
+    { 0x9B934C3B330C8577, 0x63CC55F49F88EB2F },
+    { 0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB },
+    { 0xF316271C7FC3908A, 0x8BEF464E3945EF7A },
+    { 0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC },
+    { 0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317 },
+    { 0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD },
+    { 0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A },
+    { 0xB975D6B6EE39E436, 0xB3E2FD538E122B44 },
+    { 0xE7D34C64A9C85D44, 0x60DBBCA87196B616 },
+    { 0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD },
+    { 0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41 },
+    { 0xE264589A4DCDAB14, 0xC696963C7EED2DD1 },
+    { 0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2 },
+    { 0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB },
+    { 0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE },
+    { 0x8A2DBF142DFCC7AB, 0x6E3569326C784337 },
+    { 0xACB92ED9397BF996, 0x49C2C37F07965404 },
+    { 0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906 },
+    { 0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3 },
+    { 0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C },
+    { 0xD2D80DB02AABD62B, 0xF50A3FA490C30190 },
+    { 0x83C7088E1AAB65DB, 0x792667C6DA79E0FA },
+    { 0xA4B8CAB1A1563F52, 0x577001B891185938 },
+    { 0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86 },
+    { 0x80B05E5AC60B6178, 0x544F8158315B05B4 },
+    { 0xA0DC75F1778E39D6, 0x696361AE3DB1C721 },
+    { 0xC913936DD571C84C, 0x03BC3A19CD1E38E9 },
+    { 0xFB5878494ACE3A5F, 0x04AB48A04065C723 },
+    { 0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76 },
+    { 0xC45D1DF942711D9A, 0x3BA5D0BD324F8394 },
+    { 0xF5746577930D6500, 0xCA8F44EC7EE36479 },
+    { 0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB },
+    { 0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E },
+    { 0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E },
+    { 0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12 },
+    { 0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97 },
+    { 0xEA1575143CF97226, 0xF52D09D71A3293BD },
+    { 0x924D692CA61BE758, 0x593C2626705F9C56 },
+    { 0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C },
+    { 0xE498F455C38B997A, 0x0B6DFB9C0F956447 },
+    { 0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC },
+    { 0xB2977EE300C50FE7, 0x58EDEC91EC2CB657 },
+    { 0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED },
+    { 0x8B865B215899F46C, 0xBD79E0D20082EE74 },
+    { 0xAE67F1E9AEC07187, 0xECD8590680A3AA11 },
+    { 0xDA01EE641A708DE9, 0xE80E6F4820CC9495 },
+    { 0x884134FE908658B2, 0x3109058D147FDCDD },
+    { 0xAA51823E34A7EEDE, 0xBD4B46F0599FD415 },
+    { 0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A },
+    { 0x850FADC09923329E, 0x03E2CF6BC604DDB0 },
+    { 0xA6539930BF6BFF45, 0x84DB8346B786151C },
+    { 0xCFE87F7CEF46FF16, 0xE612641865679A63 },
+    { 0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E },
+    { 0xA26DA3999AEF7749, 0xE3BE5E330F38F09D },
+    { 0xCB090C8001AB551C, 0x5CADF5BFD3072CC5 },
+    { 0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6 },
+    { 0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA },
+    { 0xC646D63501A1511D, 0xB281E1FD541501B8 },
+    { 0xF7D88BC24209A565, 0x1F225A7CA91A4226 },
+    { 0x9AE757596946075F, 0x3375788DE9B06958 },
+    { 0xC1A12D2FC3978937, 0x0052D6B1641C83AE },
+    { 0xF209787BB47D6B84, 0xC0678C5DBD23A49A },
+    { 0x9745EB4D50CE6332, 0xF840B7BA963646E0 },
+    { 0xBD176620A501FBFF, 0xB650E5A93BC3D898 },
+    { 0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE },
+    { 0x93BA47C980E98CDF, 0xC66F336C36B10137 },
+    { 0xB8A8D9BBE123F017, 0xB80B0047445D4184 },
+    { 0xE6D3102AD96CEC1D, 0xA60DC059157491E5 },
+    { 0x9043EA1AC7E41392, 0x87C89837AD68DB2F },
+    { 0xB454E4A179DD1877, 0x29BABE4598C311FB },
+    { 0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A },
+    { 0x8CE2529E2734BB1D, 0x1899E4A65F58660C },
+    { 0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F },
+    { 0xDC21A1171D42645D, 0x76707543F4FA1F73 },
+    { 0x899504AE72497EBA, 0x6A06494A791C53A8 },
+    { 0xABFA45DA0EDBDE69, 0x0487DB9D17636892 },
+    { 0xD6F8D7509292D603, 0x45A9D2845D3C42B6 },
+    { 0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2 },
+    { 0xA7F26836F282B732, 0x8E6CAC7768D7141E },
+    { 0xD1EF0244AF2364FF, 0x3207D795430CD926 },
+    { 0x8335616AED761F1F, 0x7F44E6BD49E807B8 },
+    { 0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6 },
+    { 0xCD036837130890A1, 0x36DBA887C37A8C0F },
+    { 0x802221226BE55A64, 0xC2494954DA2C9789 },
+    { 0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C },
+    { 0xC83553C5C8965D3D, 0x6F92829494E5ACC7 },
+    { 0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9 },
+    { 0x9C69A97284B578D7, 0xFF2A760414536EFB },
+    { 0xC38413CF25E2D70D, 0xFEF5138519684ABA },
+    { 0xF46518C2EF5B8CD1, 0x7EB258665FC25D69 },
+    { 0x98BF2F79D5993802, 0xEF2F773FFBD97A61 },
+    { 0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA },
+    { 0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38 },
+    { 0x952AB45CFA97A0B2, 0xDD945A747BF26183 },
+    { 0xBA756174393D88DF, 0x94F971119AEEF9E4 },
+    { 0xE912B9D1478CEB17, 0x7A37CD5601AAB85D },
+    { 0x91ABB422CCB812EE, 0xAC62E055C10AB33A },
+    { 0xB616A12B7FE617AA, 0x577B986B314D6009 },
+    { 0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B },
+    { 0x8E41ADE9FBEBC27D, 0x14588F13BE847307 },
+    { 0xB1D219647AE6B31C, 0x596EB2D8AE258FC8 },
+    { 0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB },
+    { 0x8AEC23D680043BEE, 0x25DE7BB9480D5854 },
+    { 0xADA72CCC20054AE9, 0xAF561AA79A10AE6A },
+    { 0xD910F7FF28069DA4, 0x1B2BA1518094DA04 },
+    { 0x87AA9AFF79042286, 0x90FB44D2F05D0842 },
+    { 0xA99541BF57452B28, 0x353A1607AC744A53 },
+    { 0xD3FA922F2D1675F2, 0x42889B8997915CE8 },
+    { 0x847C9B5D7C2E09B7, 0x69956135FEBADA11 },
+    { 0xA59BC234DB398C25, 0x43FAB9837E699095 },
+    { 0xCF02B2C21207EF2E, 0x94F967E45E03F4BB },
+    { 0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5 },
+    { 0xA1BA1BA79E1632DC, 0x6462D92A69731732 },
+    { 0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE },
+    { 0xFCB2CB35E702AF78, 0x5CDA735244C3D43E },
+    { 0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7 },
+    { 0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0 },
+    { 0xF6C69A72A3989F5B, 0x8AAD549E57273D45 },
+    { 0x9A3C2087A63F6399, 0x36AC54E2F678864B },
+    { 0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD },
+    { 0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5 },
+    { 0x969EB7C47859E743, 0x9F644AE5A4B1B325 },
+    { 0xBC4665B596706114, 0x873D5D9F0DDE1FEE },
+    { 0xEB57FF22FC0C7959, 0xA90CB506D155A7EA },
+    { 0x9316FF75DD87CBD8, 0x09A7F12442D588F2 },
+    { 0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F },
+    { 0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA },
+    { 0x8FA475791A569D10, 0xF96E017D694487BC },
+    { 0xB38D92D760EC4455, 0x37C981DCC395A9AC },
+    { 0xE070F78D3927556A, 0x85BBE253F47B1417 },
+    { 0x8C469AB843B89562, 0x93956D7478CCEC8E },
+    { 0xAF58416654A6BABB, 0x387AC8D1970027B2 },
+    { 0xDB2E51BFE9D0696A, 0x06997B05FCC0319E },
+    { 0x88FCF317F22241E2, 0x441FECE3BDF81F03 },
+    { 0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3 },
+    { 0xD60B3BD56A5586F1, 0x8A71E223D8D3B074 },
+    { 0x85C7056562757456, 0xF6872D5667844E49 },
+    { 0xA738C6BEBB12D16C, 0xB428F8AC016561DB },
+    { 0xD106F86E69D785C7, 0xE13336D701BEBA52 },
+    { 0x82A45B450226B39C, 0xECC0024661173473 },
+    { 0xA34D721642B06084, 0x27F002D7F95D0190 },
+    { 0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4 },
+    { 0xFF290242C83396CE, 0x7E67047175A15271 },
+    { 0x9F79A169BD203E41, 0x0F0062C6E984D386 },
+    { 0xC75809C42C684DD1, 0x52C07B78A3E60868 },
+    { 0xF92E0C3537826145, 0xA7709A56CCDF8A82 },
+    { 0x9BBCC7A142B17CCB, 0x88A66076400BB691 },
+    { 0xC2ABF989935DDBFE, 0x6ACFF893D00EA435 },
+    { 0xF356F7EBF83552FE, 0x0583F6B8C4124D43 },
+    { 0x98165AF37B2153DE, 0xC3727A337A8B704A },
+    { 0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C },
+    { 0xEDA2EE1C7064130C, 0x1162DEF06F79DF73 },
+    { 0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8 },
+    { 0xB9A74A0637CE2EE1, 0x6D953E2BD7173692 },
+    { 0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437 },
+    { 0x910AB1D4DB9914A0, 0x1D9C9892400A22A2 },
+    { 0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B },
+    { 0xE2A0B5DC971F303A, 0x2E44AE64840FD61D },
+    { 0x8DA471A9DE737E24, 0x5CEAECFED289E5D2 },
+    { 0xB10D8E1456105DAD, 0x7425A83E872C5F47 },
+    { 0xDD50F1996B947518, 0xD12F124E28F77719 },
+    { 0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F },
+    { 0xACE73CBFDC0BFB7B, 0x636CC64D1001550B },
+    { 0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E },
+    { 0x8714A775E3E95C78, 0x65ACFAEC34810A71 },
+    { 0xA8D9D1535CE3B396, 0x7F1839A741A14D0D },
+    { 0xD31045A8341CA07C, 0x1EDE48111209A050 },
+    { 0x83EA2B892091E44D, 0x934AED0AAB460432 },
+    { 0xA4E4B66B68B65D60, 0xF81DA84D5617853F },
+    { 0xCE1DE40642E3F4B9, 0x36251260AB9D668E },
+    { 0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019 },
+    { 0xA1075A24E4421730, 0xB24CF65B8612F81F },
+    { 0xC94930AE1D529CFC, 0xDEE033F26797B627 },
+    { 0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1 },
+    { 0x9D412E0806E88AA5, 0x8E1F289560EE864E },
+    { 0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2 },
+    { 0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB },
+    { 0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29 },
+    { 0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3 },
+    { 0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0 },
+    { 0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E },
+    { 0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1 },
+    { 0xEA53DF5FD18D5513, 0x84C86189216DC5ED },
+    { 0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4 },
+    { 0xB7118682DBB66A77, 0x3FBC8C33221DC2A1 },
+    { 0xE4D5E82392A40515, 0x0FABAF3FEAA5334A },
+    { 0x8F05B1163BA6832D, 0x29CB4D87F2A7400E },
+    { 0xB2C71D5BCA9023F8, 0x743E20E9EF511012 },
+    { 0xDF78E4B2BD342CF6, 0x914DA9246B255416 },
+    { 0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E },
+    { 0xAE9672ABA3D0C320, 0xA184AC2473B529B1 },
+    { 0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E },
+    { 0x8865899617FB1871, 0x7E2FA67C7A658892 },
+    { 0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7 },
+    { 0xD51EA6FA85785631, 0x552A74227F3EA565 },
+    { 0x8533285C936B35DE, 0xD53A88958F87275F },
+    { 0xA67FF273B8460356, 0x8A892ABAF368F137 },
+    { 0xD01FEF10A657842C, 0x2D2B7569B0432D85 },
+    { 0x8213F56A67F6B29B, 0x9C3B29620E29FC73 },
+    { 0xA298F2C501F45F42, 0x8349F3BA91B47B8F },
+    { 0xCB3F2F7642717713, 0x241C70A936219A73 },
+    { 0xFE0EFB53D30DD4D7, 0xED238CD383AA0110 },
+    { 0x9EC95D1463E8A506, 0xF4363804324A40AA },
+    { 0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5 },
+    { 0xF81AA16FDC1B81DA, 0xDD94B7868E94050A },
+    { 0x9B10A4E5E9913128, 0xCA7CF2B4191C8326 },
+    { 0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0 },
+    { 0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC },
+    { 0x976E41088617CA01, 0xD5BE0503E085D813 },
+    { 0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18 },
+    { 0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E },
+    { 0x93E1AB8252F33B45, 0xCABB90E5C942B503 },
+    { 0xB8DA1662E7B00A17, 0x3D6A751F3B936243 },
+    { 0xE7109BFBA19C0C9D, 0x0CC512670A783AD4 },
+    { 0x906A617D450187E2, 0x27FB2B80668B24C5 },
+    { 0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6 },
+    { 0xE1A63853BBD26451, 0x5E7873F8A0396973 },
+    { 0x8D07E33455637EB2, 0xDB0B487B6423E1E8 },
+    { 0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62 },
+    { 0xDC5C5301C56B75F7, 0x7641A140CC7810FB },
+    { 0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D },
+    { 0xAC2820D9623BF429, 0x546345FA9FBDCD44 },
+    { 0xD732290FBACAF133, 0xA97C177947AD4095 },
+    { 0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D },
+    { 0xA81F301449EE8C70, 0x5C68F256BFFF5A74 },
+    { 0xD226FC195C6A2F8C, 0x73832EEC6FFF3111 },
+    { 0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB },
+    { 0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55 },
+    { 0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB },
+    { 0x80444B5E7AA7CF85, 0x7980D163CF5B81B3 },
+    { 0xA0555E361951C366, 0xD7E105BCC332621F },
+    { 0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7 },
+    { 0xFA856334878FC150, 0xB14F98F6F0FEB951 },
+    { 0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3 },
+    { 0xC3B8358109E84F07, 0x0A862F80EC4700C8 },
+    { 0xF4A642E14C6262C8, 0xCD27BB612758C0FA },
+    { 0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C },
+    { 0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3 },
+    { 0xEEEA5D5004981478, 0x1858CCFCE06CAC74 },
+    { 0x95527A5202DF0CCB, 0x0F37801E0C43EBC8 },
+    { 0xBAA718E68396CFFD, 0xD30560258F54E6BA },
+    { 0xE950DF20247C83FD, 0x47C6B82EF32A2069 },
+    { 0x91D28B7416CDD27E, 0x4CDC331D57FA5441 },
+    { 0xB6472E511C81471D, 0xE0133FE4ADF8E952 },
+    { 0xE3D8F9E563A198E5, 0x58180FDDD97723A6 },
+    { 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648 },
+};
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 fu128_;
+#endif
+
+/* high 64 bits of the 128-bit product a * b; the low ones go to *lo */
+static INLINE uintmax_t fmul_(uintmax_t a, uintmax_t b, uintmax_t *lo) {
+#if defined(__SIZEOF_INT128__)
+    fu128_ r = (fu128_)a * b;
+    *lo = (uintmax_t)r;
+    return (uintmax_t)(r >> 64);
+#else
+    uintmax_t al = a & 0xFFFFFFFFUL, ah = a >> 32;
+    uintmax_t bl = b & 0xFFFFFFFFUL, bh = b >> 32;
+    uintmax_t ll = al * bl, lh = al * bh, hl = ah * bl;
+    uintmax_t mid = (ll >> 32) + (lh & 0xFFFFFFFFUL) + (hl & 0xFFFFFFFFUL);
+    *lo = (mid << 32) | (ll & 0xFFFFFFFFUL);
+    return ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+/* number of leading zero bits in x, which must not be 0 */
+static INLINE int fclz_(uintmax_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    if (!(x >> 32)) n += 32, x <<= 32;
+    if (!(x >> 48)) n += 16, x <<= 16;
+    if (!(x >> 56)) n += 8, x <<= 8;
+    if (!(x >> 60)) n += 4, x <<= 4;
+    if (!(x >> 62)) n += 2, x <<= 2;
+    if (!(x >> 63)) n += 1;
+    return n;
+#endif
+}
+
+/* floor(log2(10^q)) + 63 for FPOW5_MIN <= q <= FPOW5_MAX. 217706 / 2^16
+   is close enough to log2(10); the offset keeps the shift non-negative */
+static INLINE long fpow2_(int q) {
+    return ((217706L * q + (1137L << 16)) >> 16) - 1137 + 63;
+}
+
+/* w * 10^q rounded to format f with the Eisel-Lemire algorithm, for w > 0
+   and FPOW5_MIN <= q <= FPOW5_MAX. returns the bits of a positive float */
+static uintmax_t feisel_(const struct ffmt_ *f, int q, uintmax_t w) {
+    const uintmax_t *p5 = fpow5_[q - FPOW5_MIN];
+    uintmax_t hi, lo, m, mask = UINTMAX_MAX >> (f->mbits + 3);
+    int lz = fclz_(w), upper, shift;
+    long e, inf = (1L << f->ebits) - 1;
+
+    w <<= lz;
+    hi = fmul_(w, p5[0], &lo);
+    /* only if all of the bits under the mantissa and its rounding bits are
+       ones can the lower half of the power carry into them */
+    if ((hi & mask) == mask) {
+        uintmax_t lo2, hi2 = fmul_(w, p5[1], &lo2);
+        lo += hi2;
+        hi += lo < hi2;
+    }
+
+    upper = (int)(hi >> 63);
+    shift = upper + 64 - f->mbits - 3;
+    m = hi >> shift;
+    e = fpow2_(q) + upper - lz + (inf >> 1);
+    if (e <= 0) {
+        /* subnormal, or rounds up to the smallest normal */
+        if (1 - e >= 64)
+            return 0;
+        m >>= 1 - e;
+        /* binary16 subnormals are large enough to be exactly halfway,
+           which needs w to be a multiple of 5^-q, so q >= -27 */
+        if (lo <= 1 && q >= -27 && (m & 3) == 1
+                && shift + 1 - e < 64 && (m << (shift + 1 - e)) == hi)
+            m &= ~(uintmax_t)1;
+        return (m + (m & 1)) >> 1;
+    }
+
+    /* exactly halfway: round to even instead of up */
+    if (lo <= 1 && q >= f->evenlo && q <= f->evenhi && (m & 3) == 1
+            && (m << shift) == hi)
+        m &= ~(uintmax_t)1;
+    m = (m + (m & 1)) >> 1;
+    if (m >> (f->mbits + 1)) {
+        m >>= 1;
+        ++e;
+    }
+    if (e >= inf)
+        return (uintmax_t)inf << f->mbits;
+    return (m & (((uintmax_t)1 << f->mbits) - 1)) | (uintmax_t)e << f->mbits;
+}
+
+/* number of digits kept for the exact conversion; enough to tell which way
+   any double rounds, and the ones past them only matter if nonzero */
+#define FDEC_DIGITS 800
+
+/* the largest shift by which fdshift_ moves at a time, so that any digit
+   shifted by it still fits in 64 bits with room to spare */
+#define FDEC_SHIFT 60
+
+/* a decimal number 0.d[0]d[1]...d[nd - 1] * 10^dp for exact conversions */
+struct fdec_ {
+    unsigned char d[FDEC_DIGITS];   /* digits, most significant first */
+    int nd;                         /* number of digits */
+    int dp;                         /* position of the decimal point */
+    BOOL trunc;                     /* nonzero digits were dropped from d */
+};
+
+/* drop trailing zeros */
+static void fdtrim_(struct fdec_ *a) {
+    while (a->nd > 0 && !a->d[a->nd - 1])
+        --a->nd;
+    if (!a->nd)
+        a->dp = 0;
+}
+
+/* a = a * 2^k */
+static void fdlshift_(struct fdec_ *a, int k) {
+    int r, w, delta = 0;
+    uintmax_t n = 0;
+    /* count the new leading digits first */
+    for (r = a->nd - 1; r >= 0; --r)
+        n = (n + ((uintmax_t)a->d[r] << k)) / 10;
+    for (; n; n /= 10)
+        ++delta;
+
+    w = a->nd + delta;
+    for (r = a->nd - 1; r >= 0; --r) {
+        n += (uintmax_t)a->d[r] << k;
+        if (--w < FDEC_DIGITS)
+            a->d[w] = (unsigned char)(n % 10);
+        else if (n % 10)
+            a->trunc = 1;
+        n /= 10;
+    }
+    for (; n; n /= 10)
+        a->d[--w] = (unsigned char)(n % 10);
+
+    a->nd += delta;
+    if (a->nd > FDEC_DIGITS)
+        a->nd = FDEC_DIGITS;
+    a->dp += delta;
+    fdtrim_(a);
+}
+
+/* a = a / 2^k */
+static void fdrshift_(struct fdec_ *a, int k) {
+    int r = 0, w = 0;
+    uintmax_t n = 0, mask = ((uintmax_t)1 << k) - 1;
+    /* pick up enough leading digits to cover the first shift */
+    for (; !(n >> k); ++r) {
+        if (r >= a->nd) {
+            if (!n) {
+                a->nd = 0;
+                return;
+            }
+            while (!(n >> k)) {
+                n *= 10;
+                ++r;
+            }
+            break;
+        }
+        n = n * 10 + a->d[r];
+    }
+    a->dp -= r - 1;
+
+    /* pick up a digit, put down a digit */
+    for (; r < a->nd; ++r) {
+        unsigned c = a->d[r];
+        a->d[w++] = (unsigned char)(n >> k);
+        n = (n & mask) * 10 + c;
+    }
+    /* put down the rest */
+    for (; n; n = (n & mask) * 10) {
+        if (w < FDEC_DIGITS)
+            a->d[w++] = (unsigned char)(n >> k);
+        else if (n >> k)
+            a->trunc = 1;
+    }
+    a->nd = w;
+    fdtrim_(a);
+}
+
+/* a = a * 2^k, k may be negative */
+static void fdshift_(struct fdec_ *a, int k) {
+    if (!a->nd)
+        return;
+    for (; k > FDEC_SHIFT; k -= FDEC_SHIFT)
+        fdlshift_(a, FDEC_SHIFT);
+    for (; k < -FDEC_SHIFT; k += FDEC_SHIFT)
+        fdrshift_(a, FDEC_SHIFT);
+    if (k > 0)
+        fdlshift_(a, k);
+    else if (k < 0)
+        fdrshift_(a, -k);
+}
+
+/* a rounded to an integer (half to even); a must be under 10^20 */
+static uintmax_t fdround_(const struct fdec_ *a) {
+    uintmax_t n = 0;
+    int i;
+    BOOL up;
+    for (i = 0; i < a->dp && i < a->nd; ++i)
+        n = n * 10 + a->d[i];
+    for (; i < a->dp; ++i)
+        n *= 10;
+    if (a->dp < 0 || a->dp >= a->nd)
+        up = 0;
+    else if (a->d[a->dp] == 5 && a->dp + 1 == a->nd)
+        /* halfway, unless digits were dropped */
+        up = a->trunc || (a->dp > 0 && (a->d[a->dp - 1] & 1));
+    else
+        up = a->d[a->dp] >= 5;
+    return n + up;
+}
+
+/* a rounded to format f exactly, by shifting it into [1, 2) one power of
+   two at a time. returns the bits of a positive float; a is clobbered */
+static uintmax_t fdbits_(struct fdec_ *a, const struct ffmt_ *f) {
+    /* the shifts that bring dp down or up by about 1, 2, 3, ... */
+    static const unsigned char powtab[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    long bias = (1L << (f->ebits - 1)) - 1, inf = (1L << f->ebits) - 1;
+    long e = 0;
+    uintmax_t m;
+    if (!a->nd || a->dp < -330)
+        return 0;
+    if (a->dp > 310)
+        return (uintmax_t)inf << f->mbits;
+
+    /* bring a into [0.5, 1) */
+    while (a->dp > 0) {
+        int n = a->dp < 9 ? powtab[a->dp] : 27;
+        fdshift_(a, -n);
+        e += n;
+    }
+    while (a->dp < 0 || (!a->dp && a->d[0] < 5)) {
+        int n = -a->dp < 9 ? powtab[-a->dp] : 27;
+        fdshift_(a, n);
+        e -= n;
+    }
+    /* and then into [1, 2), and down to the subnormal range if needed */
+    --e;
+    if (e < 1 - bias) {
+        fdshift_(a, (int)(e - 1 + bias));
+        e = 1 - bias;
+    }
+    if (e + bias >= inf)
+        return (uintmax_t)inf << f->mbits;
+
+    fdshift_(a, f->mbits + 1);
+    m = fdround_(a);
+    if (m >> (f->mbits + 1)) {
+        m >>= 1;
+        if (++e + bias >= inf)
+            return (uintmax_t)inf << f->mbits;
+    }
+    if (!(m >> f->mbits))
+        e = -bias;
+    return (m & (((uintmax_t)1 << f->mbits) - 1))
+         | (uintmax_t)(e + bias) << f->mbits;
+}
+
+/* w * 10^q rounded to format f, where w holds the first 19 significant
+   digits and trunc is set if any of those after them are nonzero; a has
+   those in d[19...], with nd, dp and trunc set, should they be needed.
+   returns the bits of a positive float */
+static uintmax_t ftobits_(const struct ffmt_ *f, uintmax_t w, intmax_t q,
+                          BOOL trunc, struct fdec_ *a) {
+    uintmax_t b;
+    if (!w || q < FPOW5_MIN)
+        return 0;
+    if (q > FPOW5_MAX)
+        return (uintmax_t)((1L << f->ebits) - 1) << f->mbits;
+    b = feisel_(f, (int)q, w);
+    if (trunc && feisel_(f, (int)q, w + 1) != b) {
+        /* too close to call; put the first digits in front of the rest */
+        int i;
+        for (i = 18; i >= 0; --i) {
+            a->d[i] = (unsigned char)(w % 10);
+            w /= 10;
+        }
+        fdtrim_(a);
+        b = fdbits_(a, f);
+    }
+    return b;
+}
+
+/* w * 2^e rounded to format f, where sticky is set if there are nonzero
+   bits below w. returns the bits of a positive float */
+static uintmax_t fxbits_(const struct ffmt_ *f, uintmax_t w, intmax_t e,
+                         BOOL sticky) {
+    long bias = (1L << (f->ebits - 1)) - 1, inf = (1L << f->ebits) - 1;
+    /* bits under the mantissa, which are rounded off */
+    int shift = 63 - f->mbits, lz;
+    uintmax_t m, r, half;
+    if (!w)
+        return 0;
+    lz = fclz_(w);
+    w <<= lz;
+    /* the biased exponent of the leading bit of w */
+    e += 63 - lz + bias;
+    if (e >= inf)
+        return (uintmax_t)inf << f->mbits;
+    if (e <= 0) {
+        /* subnormal; the leading bit is further down */
+        if (1 - e > 64 - shift)
+            return 0;
+        shift += (int)(1 - e);
+    }
+
+    if (shift < 64) {
+        m = w >> shift;
+        r = w & (((uintmax_t)1 << shift) - 1);
+        half = (uintmax_t)1 << (shift - 1);
+    } else {
+        m = 0;
+        r = w;
+        half = (uintmax_t)1 << 63;
+    }
+    if (r > half || (r == half && (sticky || (m & 1))))
+        ++m;
+    /* the leading one of m, if any, adds one to the exponent (and any
+       carry from rounding another) */
+    m += (uintmax_t)(e > 0 ? e - 1 : 0) << f->mbits;
+    if (m >= (uintmax_t)inf << f->mbits)
+        return (uintmax_t)inf << f->mbits;
+    return m;
+}
+
+/* the float and double with the given bits */
+static INLINE float fbtof_(uintmax_t b) {
+    union { unsigned u; float f; } v;
+    v.u = (unsigned)b;
+    return v.f;
+}
+
+static INLINE double fbtod_(uintmax_t b) {
+    union { uintmax_t u; double d; } v;
+    v.u = b;
+    return v.d;
+}
+
+#if SCANF_EXACT_EVAL
+/* powers of ten that are exact as floats and doubles */
+static const float fp10f_[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static const double fp10_[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#endif
+
+/* w * 10^q correctly rounded to float and double; see ftobits_. if w and
+   10^q are both exact in the type, one multiplication or division rounds
+   correctly (Clinger's fast path) */
+static INLINE float ftof_(uintmax_t w, intmax_t q, BOOL trunc,
+                          struct fdec_ *a) {
+#if SCANF_EXACT_EVAL
+    if (!trunc && w <= (uintmax_t)1 << 24 && q >= -10 && q <= 10) {
+        float r = (float)w;
+        return q < 0 ? r / fp10f_[-q] : r * fp10f_[q];
+    }
+#endif
+    return fbtof_(ftobits_(&fbin32_, w, q, trunc, a));
+}
+
+static INLINE double ftod_(uintmax_t w, intmax_t q, BOOL trunc,
+                           struct fdec_ *a) {
+#if SCANF_EXACT_EVAL
+    if (!trunc && w <= (uintmax_t)1 << 53 && q >= -22 && q <= 22) {
+        double r = (double)w;
+        return q < 0 ? r / fp10_[-q] : r * fp10_[q];
+    }
+#endif
+    return fbtod_(ftobits_(&fbin64_, w, q, trunc, a));
+}
+#endif /* SCANF_USE_EXACT_FLOAT */
+
 #endif /* !SCANF_DISABLE_SUPPORT_FLOAT */
 
 #endif /* SCANF_REPEAT */
@@ -694,7 +2027,42 @@ static floatmax_t powi_(floatmax_t x, intmax_t y) {
  *        scanset functions        *
  * =============================== */
 
-#if !SCANF_DISABLE_SUPPORT_SCANSET && !SCANF_CAN_FAST_SCANSET
+#if !SCANF_DISABLE_SUPPORT_SCANSET && SCANF_CAN_FAST_SCANSET
+
+#ifndef SCANF_REPEAT
+/* scanset bitmaps, one bit per character for the first SSET_SIZE ones */
+#define SSET_SIZE 256
+#define SSET_WBITS (sizeof(unsigned) * CHAR_BIT)
+#define SSET_WORDS ((SSET_SIZE + SSET_WBITS - 1) / SSET_WBITS)
+#endif /* SCANF_REPEAT */
+
+/* add the characters lo-hi to a scanset bitmap */
+static void F_(isetrange_)(unsigned *mask, UCHAR lo, UCHAR hi) {
+    unsigned l = (unsigned)lo, h = (unsigned)hi, lw, hw;
+#if SCANF_SCANSET_HIGH
+    if (lo >= SSET_SIZE)
+        return;
+    if (hi >= SSET_SIZE)
+        h = SSET_SIZE - 1;
+#endif
+    if (l > h)
+        return;
+    lw = l / SSET_WBITS, hw = h / SSET_WBITS;
+    if (lw == hw) {
+        mask[lw] |= (~0U << (l % SSET_WBITS))
+                  & (~0U >> (SSET_WBITS - 1 - h % SSET_WBITS));
+        return;
+    }
+    mask[lw] |= ~0U << (l % SSET_WBITS);
+    while (++lw < hw)
+        mask[lw] = ~0U;
+    mask[hw] |= ~0U >> (SSET_WBITS - 1 - h % SSET_WBITS);
+}
+
+#endif
+
+#if !SCANF_DISABLE_SUPPORT_SCANSET                                             \
+    && (!SCANF_CAN_FAST_SCANSET || SCANF_SCANSET_HIGH)
 
 static BOOL F_(inscan_)(const UCHAR *begin, const UCHAR *end, UCHAR c) {
     BOOL hyphen = 0;
@@ -720,527 +2088,3192 @@ static BOOL F_(inscan_)(const UCHAR *begin, const UCHAR *end, UCHAR c) {
 #endif
 
 /* =============================== *
- *      conversion  functions      *
+ *           SIMD kernels          *
  * =============================== */
 
-#ifndef SCANF_REPEAT
-        /* still characters to read? (not EOF and width not exceeded) */
-#define KEEP_READING() (nowread < maxlen && !GOT_EOF())
-        /* read next char and increment counter */
-#define NEXT_CHAR(counter) (next = getch(p), ++counter)
+#if SCANF_USE_SIMD || SCANF_USE_SWAR
+/* the kernels read whole blocks around strings, which the address sanitizer
+   would report even though they are never out of bounds of the page */
+#if defined(__SANITIZE_ADDRESS__)
+#define VNOASAN __attribute__((no_sanitize_address))
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define VNOASAN __attribute__((no_sanitize_address))
+#endif
+#endif
+#ifndef VNOASAN
+#define VNOASAN
+#endif
 #endif
 
-#undef IS_EOF
-#undef GCEOF
-/* EOF check */
-#if SCANF_WIDE
-#define IS_EOF(c) ((c) == WEOF)
-#define GCEOF WEOF
+#if SCANF_USE_SIMD
+
+#if defined(__GNUC__)
+#define VCTZ(x) ((unsigned)__builtin_ctz(x))
 #else
-#define IS_EOF(c) ((c) < 0)
-#define GCEOF EOF
+static INLINE unsigned vctz_(unsigned x) {
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return (unsigned)i;
+}
+#define VCTZ(x) vctz_(x)
 #endif
 
-#undef GOT_EOF
-#define GOT_EOF() (IS_EOF(next))
+/* number of characters in a block */
+#define VBLOCK 16
 
-/* convert stream to integer
-    getch: stream read function
-    p: pointer to pass to above
-    nextc: pointer to next character in buffer
-    readin: pointer to number of characters read
-    maxlen: value that *readin should be at most
-    base: 10 for decimal, 16 for hexadecimal, etc.
-    unsign: whether the result should be unsigned
-    negative: whether there was a - sign
-    zero: if no digits, allow zero (i.e. read zero before iaton_)
-    dest: intmax_t* or uintmax_t*, where result is stored
+/* most ranges a class can be made of before it has to use a table */
+#define VCLASS_RANGES 8
 
-    return value: 1 if conversion OK, 0 if not
-                  (if 0, dest guaranteed to not be modified)
-*/
-static INLINE BOOL F_(iaton_)(CINT (*getch)(void *p), void *p, CINT *nextc,
-                size_t *readin, size_t maxlen, int base, BOOL unsign,
-                BOOL negative, BOOL zero, void *dest) {
-    CINT next = *nextc;
-    size_t nowread = *readin;
-    uintmax_t r = 0, pr = 0;
-    /* read digits? overflow? */
-    BOOL digit = 0, ovf = 0;
+/* a class of characters for the kernels, the union of the ranges lo-hi */
+struct vclass_ {
+    unsigned n;
+    BOOL invert;
+    /* set if there were too many ranges; map is used instead */
+    BOOL table;
+    unsigned char lo[VCLASS_RANGES], hi[VCLASS_RANGES];
+#ifdef __SSSE3__
+    /* bit c % 8 of map[c / 8] set if c is in the class */
+    unsigned char map[32];
+#endif
+};
 
-#if !SCANF_MINIMIZE
-    /* skip initial zeros */
-    while (KEEP_READING() && next == C_('0')) {
-        digit = 1;
-        NEXT_CHAR(nowread);
+/* whether a class can be matched by vmatch_ */
+#ifdef __SSSE3__
+#define VCLASS_OK(cl) 1
+#else
+#define VCLASS_OK(cl) (!(cl)->table)
+#endif
+
+/* bit i of the return value is set if character i of x is in the class */
+static INLINE unsigned vmatch_(const struct vclass_ *cl, __m128i x) {
+    __m128i m = _mm_setzero_si128();
+    unsigned r;
+#ifdef __SSSE3__
+    if (cl->table) {
+        /* look up the byte of map for each character, then the bit */
+        __m128i i = _mm_and_si128(_mm_srli_epi16(x, 3), _mm_set1_epi8(0x1F));
+        __m128i h = _mm_cmpgt_epi8(i, _mm_set1_epi8(15));
+        __m128i b = _mm_or_si128(
+            _mm_andnot_si128(h, _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i *)cl->map), i)),
+            _mm_and_si128(h, _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i *)(cl->map + 16)), i)));
+        __m128i bit = _mm_shuffle_epi8(
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                          1, 2, 4, 8, 16, 32, 64, -128),
+            _mm_and_si128(x, _mm_set1_epi8(7)));
+        m = _mm_cmpeq_epi8(_mm_and_si128(b, bit), bit);
+    } else
+#endif
+    for (r = 0; r < cl->n; ++r) {
+        __m128i lo = _mm_set1_epi8((char)cl->lo[r]);
+        if (cl->lo[r] == cl->hi[r])
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, lo));
+        else /* x - lo <= hi - lo, unsigned */
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_subs_epu8(
+                    _mm_sub_epi8(x, lo),
+                    _mm_set1_epi8((char)(cl->hi[r] - cl->lo[r]))),
+                _mm_setzero_si128()));
     }
-#endif
+    r = (unsigned)_mm_movemask_epi8(m);
+    return cl->invert ? r ^ 0xFFFFU : r;
+}
 
-    /* read digits and convert to integer */
-    while (KEEP_READING() && F_(isdigr_)(next, base)) {
-        if (!ovf) {
-            digit = 1;
-            r = r * base + F_(ctorn_)(next, base);
-            if (pr > r)
-                ovf = 1;
-            else
-                pr = r; 
+/*
+    count the characters in a class
+    cl: the class
+    p: the characters
+    n: the most characters to count
+    string: if set, p is a null-terminated string, and the null character is
+            never in the class. blocks are then read from addresses aligned
+            to VBLOCK, which never reach into memory that may not exist.
+            if not set, exactly n characters are available and only whole
+            blocks of them are looked at
+
+    return value: number of characters at p in the class
+*/
+static VNOASAN size_t vspan_(const struct vclass_ *cl, const unsigned char *p,
+                     size_t n, BOOL string) {
+    size_t i = 0, skip;
+    unsigned m;
+    __m128i x;
+    if (string) {
+        /* the first block also has skip characters before p */
+        skip = (size_t)(PTR_TO_INT(p) & (VBLOCK - 1));
+        p -= skip;
+        for (;;) {
+            x = _mm_load_si128((const __m128i *)p);
+            m = (vmatch_(cl, x) & ~(unsigned)_mm_movemask_epi8(
+                        _mm_cmpeq_epi8(x, _mm_setzero_si128())))
+                | ((1U << skip) - 1);
+            if (m != 0xFFFFU) {
+                i += VCTZ(~m) - skip;
+                break;
+            }
+            i += VBLOCK - skip;
+            if (i >= n)
+                break;
+            p += VBLOCK, skip = 0;
         }
-        NEXT_CHAR(nowread);
+        return i < n ? i : n;
+    }
+    while (n - i >= VBLOCK) {
+        m = vmatch_(cl, _mm_loadu_si128((const __m128i *)(p + i)));
+        if (m != 0xFFFFU)
+            return i + VCTZ(~m);
+        i += VBLOCK;
     }
+    return i;
+}
 
-    /* if no digits read? */
-    if (digit) {
-        /* overflow detection, negation, etc. */
-        if (unsign) {
-            if (ovf)
-                r = (intmax_t)UINTMAX_MAX;
-            else if (negative)
-#if SCANF_CLAMP
-                r = 0;
-#else
-                r = (uintmax_t)-r;
-#endif
-            *(uintmax_t *)dest = r;
-        } else {
-            intmax_t sr;
-            if (ovf || (negative ? (intmax_t)r < 0
-                                 : r > (uintmax_t)INTMAX_MAX))
-                sr = negative ? INTMAX_MIN : INTMAX_MAX;
-            else {
-                sr = negative ? -(intmax_t)r : (intmax_t)r;
+/* copy n characters */
+static void vcopy_(unsigned char *out, const unsigned char *p, size_t n) {
+    for (; n >= VBLOCK; n -= VBLOCK, p += VBLOCK, out += VBLOCK)
+        _mm_storeu_si128((__m128i *)out,
+                         _mm_loadu_si128((const __m128i *)p));
+    while (n--)
+        *out++ = *p++;
+}
+
+/* make a class of whitespace (in the C locale) */
+static void vspaceclass_(struct vclass_ *cl, BOOL invert) {
+    cl->n = 2, cl->invert = invert, cl->table = 0;
+    cl->lo[0] = '\t', cl->hi[0] = '\r';
+    cl->lo[1] = cl->hi[1] = ' ';
+}
+
+/* count the whitespace at ptr, up to end (NULL if a string). kept out of
+   line so that SKIP_SPACE stays small */
+static NOINLINE size_t vspanspace_(const unsigned char *ptr,
+                                   const unsigned char *end) {
+    struct vclass_ cl;
+    vspaceclass_(&cl, 0);
+    return vspan_(&cl, ptr, end ? (size_t)(end - ptr) : SIZE_MAX, !end);
+}
+
+#if !SCANF_DISABLE_SUPPORT_SCANSET && SCANF_CAN_FAST_SCANSET
+/* make a class out of a scanset bitmap */
+static void vsetclass_(struct vclass_ *cl, const unsigned *mask,
+                       BOOL invert) {
+    unsigned c = 0, w, n = 0;
+    cl->invert = invert;
+    cl->table = 0;
+    while (c < SSET_SIZE) {
+        /* find the start of the next run of set bits... */
+        w = mask[c / SSET_WBITS] >> (c % SSET_WBITS);
+        if (!w) {
+            c = (c / SSET_WBITS + 1) * SSET_WBITS;
+            continue;
+        }
+        c += VCTZ(w);
+        if (n == VCLASS_RANGES) {
+            cl->table = 1;
+            break;
+        }
+        cl->lo[n] = (unsigned char)c;
+        /* ...and its end */
+        while (c < SSET_SIZE) {
+            w = ~mask[c / SSET_WBITS] >> (c % SSET_WBITS);
+            if (w) {
+                c += VCTZ(w);
+                break;
             }
-            *(intmax_t *)dest = sr;
+            c = (c / SSET_WBITS + 1) * SSET_WBITS;
         }
-    } else if (zero) {
-        if (unsign)
-            *(uintmax_t *)dest = 0;
-        else
-            *(intmax_t *)dest = 0;
-        digit = 1;
+        cl->hi[n++] = (unsigned char)(c - 1);
     }
-
-    *nextc = next;
-    *readin = nowread;
-    return digit;
+    cl->n = n;
+#ifdef __SSSE3__
+    if (cl->table)
+        for (c = 0; c < 32; ++c)
+            cl->map[c] = (unsigned char)(mask[c * 8 / SSET_WBITS]
+                                                >> (c * 8 % SSET_WBITS));
+#endif
 }
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET && SCANF_CAN_FAST_SCANSET */
 
-#if !SCANF_DISABLE_SUPPORT_FLOAT
-/* convert stream to floating point
-    getch: stream read function
-    p: pointer to pass to above
-    nextc: pointer to next character in buffer
-    readin: pointer to number of characters read
-    maxlen: value that *readin should be at most
-    hex: whether in hex mode
-    negative: whether there was a - sign
-    zero: if no digits, allow zero (i.e. read zero before iatof_)
-    dest: floatmax_t*, where result is stored
+/* can the kernels run from ptr on? windows need a whole block left */
+#define VSPAN_OK(ptr, end) (!(end) || (size_t)((end) - (ptr)) >= VBLOCK)
 
-    return value: 1 if conversion OK, 0 if not
-                  (if 0, dest guaranteed to not be modified)
-*/
-static INLINE BOOL F_(iatof_)(CINT (*getch)(void *p), void *p, CINT *nextc,
-                       size_t *readin, size_t maxlen, BOOL hex, BOOL negative,
-                       BOOL zero, floatmax_t *dest) {
-    CINT next = *nextc;
-    size_t nowread = *readin;
-    floatmax_t r = 0, pr = 0;
-    /* saw dot? saw digit? was there an overflow? */
-    BOOL dot = 0, digit = 0, ovf = 0;
-    /* exponent, offset (with decimals, etc.) */
-    intmax_t exp = 0, off = 0;
-    /* how much to subtract from off with every digit */
-    int sub = 0;
-    /* base */
-    int base = hex ? 16 : 10;
-    /* exponent character */
-    CHAR expuc = hex ? 'P' : 'E', explc = hex ? 'p' : 'e';
+#endif /* SCANF_USE_SIMD */
 
-#if !SCANF_MINIMIZE
-    while (KEEP_READING() && next == C_('0')) {
-        digit = 1;
-        NEXT_CHAR(nowread);
-    }
-#endif
+/* =============================== *
+ *           SWAR kernels          *
+ * =============================== */
 
-    /* read digits and convert */
-    while (KEEP_READING()) {
-        if (F_(isdigr_)(next, base)) {
-            if (!ovf) {
-                digit = 1;
-                r = r * base + F_(ctorn_)(next, base);
-                if (r > 0 && pr == r) {
-                    ovf = 1;
-                } else {
-                    pr = r;
-                    off += sub;
-                }
-            }
-        } else if (next == C_('.')) {
-            if (dot)
-                break;
-            dot = 1, sub = hex ? 4 : 1;
-        } else
-            break;
-        NEXT_CHAR(nowread);
-    }
+#if SCANF_USE_SWAR
 
-    if (zero && !digit)
-        digit = 1;
-        /* r == 0 should already apply */
+/* number of characters in a word */
+#define SWORD 8
 
-    if (digit) {
-        /* exponent? */
-        if (KEEP_READING() && (next == explc || next == expuc)) {
-            BOOL eneg = 0;
-            NEXT_CHAR(nowread);
-            if (KEEP_READING()) {
-                switch (next) {
-                case C_('-'):
-                    eneg = 1;
-                    /* fall-through */
-                case C_('+'):
-                    NEXT_CHAR(nowread);
-                }
-            }
+/* the smallest page size of any target, i.e. reads within an aligned block
+   of this size cannot fault if any of it can be read */
+#define SPAGE 4096
+
+/* a word with every byte set to x */
+#define SBYTES(x) ((uintmax_t)(x) * (UINTMAX_MAX / 255))
+
+/* the SWORD characters at p as a word, the first in the lowest byte */
+#if defined(__GNUC__) && defined(__BYTE_ORDER__)                               \
+    && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+typedef uintmax_t sword_ __attribute__((may_alias, aligned(1)));
+#define SLOAD(p) (*(const sword_ *)(const void *)(p))
+#else
+#define SLOAD(p) ((uintmax_t)(p)[0]       | (uintmax_t)(p)[1] << 8             \
+                | (uintmax_t)(p)[2] << 16 | (uintmax_t)(p)[3] << 24            \
+                | (uintmax_t)(p)[4] << 32 | (uintmax_t)(p)[5] << 40            \
+                | (uintmax_t)(p)[6] << 48 | (uintmax_t)(p)[7] << 56)
+#endif
+
+/* high bit set in every byte of w that is between lo and hi (both < 0x80) */
+static INLINE uintmax_t srange_(uintmax_t w, unsigned lo, unsigned hi) {
+    uintmax_t x = w & SBYTES(0x7F);
+    return (x + SBYTES(0x80 - lo)) & ~(x + SBYTES(0x7F - hi)) & ~w
+                & SBYTES(0x80);
+}
 
-            if (!F_(iaton_)(getch, p, &next, &nowread, maxlen, 10,
-                            0, eneg, 0, &exp))
-                digit = 0;
+/* a cheaper isdigr_, as the kernels are ASCII only anyway */
+static INLINE BOOL sisdigr_(unsigned c, int base) {
+    return c - '0' < (unsigned)(base < 10 ? base : 10)
+        || (base == 16 && (c | 0x20) - 'a' < 6);
+}
+
+/*
+    convert digits, a word of them at a time
+    p: the characters
+    n: the most characters to convert
+    string: if set, p is a null-terminated string. words are then read past
+            its end, but never across a SPAGE boundary, so they never touch
+            memory that may not exist. if not set, exactly n characters are
+            available
+    base: 2, 8, 10 or 16
+    r: the value of the digits before p, to which these are added
+
+    return value: number of characters converted, a multiple of SWORD. stops
+                  before the first word that is not all digits, or once *r is
+                  too large to take another word without a chance of
+                  overflow; the caller converts the rest
+*/
+static NOINLINE VNOASAN size_t sdigits_(const unsigned char *p, size_t n,
+                                        BOOL string, int base, uintmax_t *r) {
+    size_t i = 0;
+    uintmax_t w, m, x, v = *r, b2 = (uintmax_t)base * base;
+    /* base^SWORD and x are both at most 2^32, so v * base^SWORD + x cannot
+       overflow while v is below that */
+    while (n - i >= SWORD && v <= (UINTMAX_MAX >> 32)) {
+        if (string && (PTR_TO_INT(p + i) & (SPAGE - 1)) > SPAGE - SWORD)
+            break;
+        w = SLOAD(p + i);
+
+        /* are all of the characters digits? */
+        switch (base) {
+        case 16:
+            x = srange_(w | SBYTES(0x20), 'a', 'f');
+            m = srange_(w, '0', '9') | x;
+            /* letters are 9 more than their low four bits */
+            x = (w & SBYTES(0x0F)) + (x >> 7) * 9;
+            break;
+        case 8:
+            m = srange_(w, '0', '7');
+            x = w & SBYTES(0x0F);
+            break;
+        case 2:
+            m = srange_(w, '0', '1');
+            x = w & SBYTES(0x0F);
+            break;
+        default:
+            m = srange_(w, '0', '9');
+            x = w & SBYTES(0x0F);
         }
+        if (m != SBYTES(0x80))
+            break;
+
+        /* combine the digits pairwise, the first being the most significant */
+        x = (x * (base * 256 + 1)) >> 8;
+        x = ((x & UINTMAX_MAX / 0x101) * (b2 * 65536 + 1)) >> 16;
+        x = ((x & UINTMAX_MAX / 0x10001) * ((b2 * b2 << 32) + 1)) >> 32;
+
+        v = base == 10 ? v * 100000000UL + x
+                       : v << (base == 16 ? 32 : base == 8 ? 24 : 8) | x;
+        i += SWORD;
     }
+    *r = v;
+    return i;
+}
 
-    if (digit) {
-        if (dot) {
-            intmax_t oexp = exp;
-            exp -= off;
-            if (exp > oexp) exp = INTMAX_MIN; /* underflow protection */
-        }
+#endif /* SCANF_USE_SWAR */
 
-        if (r != 0) {
-            if (exp > 0) {
-#ifdef INFINITY
-#if FLT_RADIX == 2
-                if (exp > (hex ? LDBL_MAX_EXP : LDBL_MAX_10_EXP))
-#else
-                /* FLT_RADIX > 2 means LDBL_MAX_EXP is defined as e
-                    in b^e for some b > 2; we'd need to compute
-                    LDBL_MAX_EXP * log(b) / log(2)
-                    at compile time, which is hardly an option.
-                    so instead we'll do the next best thing */
-                if (exp > (hex ? (LDBL_MAX_EXP * FLT_RADIX + 1)
-                                : LDBL_MAX_10_EXP))
-#endif
-                    r = INFINITY;
-                else
-#endif
-                    r *= powi_(hex ? 2 : 10, exp);
-            } else if (exp < 0) {
-#if FLT_RADIX == 2
-                if (exp < (hex ? LDBL_MIN_EXP : LDBL_MIN_10_EXP))
+/* =============================== *
+ *          input sources          *
+ * =============================== */
+
+#undef IS_EOF
+#undef GCEOF
+/* EOF check */
+#if SCANF_WIDE
+#define IS_EOF(c) ((c) == WEOF)
+#define GCEOF WEOF
 #else
-                if (exp < (hex ? (LDBL_MIN_EXP * FLT_RADIX - 1)
-                                : LDBL_MIN_10_EXP))
+#define IS_EOF(c) ((c) < 0)
+#define GCEOF EOF
 #endif
-                    r = 0;
-                else
-                    r /= powi_(hex ? 2 : 10, -exp);
+
+#ifndef SCANF_REPEAT
+enum sinput_kind {
+    SI_GETCH,       /* getch/ungetch pair, one character at a time */
+    SI_BLOCK,       /* refill/consume pair, one window at a time */
+    SI_STRING,      /* null-terminated string in memory, end = NULL */
+    SI_BUFFER       /* memory of known length, a single window */
+};
+#endif /* SCANF_REPEAT */
+
+/* input source. characters are read directly from the current window
+   [ptr, end), and the source is only called back once it runs out or a null
+   character is found. strings have no end; their null terminator ends them */
+struct F_(sinput_) {
+    /* next character to read, end of window, start of window */
+    const UCHAR *ptr, *end, *begin;
+    enum sinput_kind kind;
+    /* set once the source has returned EOF; it is not called again */
+    BOOL eof;
+    /* SI_GETCH */
+    CINT (*getch)(void *data);
+    void (*ungetch)(CINT c, void *data);
+    /* SI_BLOCK */
+    size_t (*refill)(const CHAR **buf, void *data);
+    void (*consume)(size_t n, void *data);
+    /* passed to the callbacks above */
+    void *data;
+    /* one-character window for SI_GETCH */
+    UCHAR buf[1];
+};
+
+/* set up an input source with an empty window */
+static void F_(sinit_)(struct F_(sinput_) *in, enum sinput_kind kind,
+                       void *data) {
+    in->ptr = in->end = in->begin = in->buf;
+    in->kind = kind;
+    in->eof = 0;
+    in->data = data;
+}
+
+/* the current window has been exhausted; set up the next one and return
+   its first character, or EOF if the source has run dry */
+static CINT F_(srefill_)(struct F_(sinput_) *in) {
+    if (in->ptr != in->end) {
+        /* stopped at a null character. it terminates a string, but is just
+           another character in any other source */
+        if (in->kind != SI_STRING)
+            return C_('\0');
+        in->eof = 1;
+        return GCEOF;
+    }
+    if (!in->eof) {
+        switch (in->kind) {
+        case SI_GETCH:
+        {
+            CINT c = in->getch(in->data);
+            if (!IS_EOF(c)) {
+                in->buf[0] = (UCHAR)c;
+                in->ptr = in->begin = in->buf;
+                in->end = in->buf + 1;
+                return c;
             }
+            break;
         }
-
-        if (negative) r = -r;
-        *dest = r;
+        case SI_BUFFER:
+            /* there is only the one window */
+            break;
+        default: /* SI_BLOCK */
+        {
+            const CHAR *buf;
+            size_t n = in->refill(&buf, in->data);
+            if (n) {
+                in->ptr = in->begin = (const UCHAR *)buf;
+                in->end = in->begin + n;
+                return (CINT)*in->ptr;
+            }
+            break;
+        }
+        }
+        in->eof = 1;
     }
+    in->ptr = in->begin = in->end;
+    return GCEOF;
+}
 
-    *nextc = next;
-    *readin = nowread;
-    return digit;
+/* give the unread part of the current window back to the source */
+static void F_(sfinish_)(struct F_(sinput_) *in) {
+    switch (in->kind) {
+    case SI_GETCH:
+        if (in->ptr != in->end && in->ungetch)
+            in->ungetch((CINT)*in->ptr, in->data);
+        break;
+    case SI_BLOCK:
+        if (in->consume)
+            in->consume((size_t)(in->ptr - in->begin), in->data);
+        break;
+    case SI_STRING:
+    case SI_BUFFER:
+        /* nothing to give back; the caller reads in->ptr */
+        break;
+    }
 }
-#endif /* !SCANF_DISABLE_SUPPORT_FLOAT */
+
+/* =============================== *
+ *      conversion  functions      *
+ * =============================== */
 
 #ifndef SCANF_REPEAT
-enum iscans_type { A_CHAR, A_STRING, A_SCANSET };
-#endif /* SCANF_REPEAT */
+        /* still characters to read? (not EOF and width not exceeded) */
+#define KEEP_READING() (nowread < maxlen && !GOT_EOF())
+        /* cache the window position of input source in into ptr and end */
+#define LOAD_INPUT() (ptr = in->ptr, end = in->end)
+        /* write the cached window position back into in */
+#define SAVE_INPUT() (in->ptr = ptr)
+        /* read next char and increment counter. the source is only called
+           back once the current window is exhausted */
+#define NEXT_CHAR(counter) (next = ++ptr != end && *ptr ? (CINT)*ptr           \
+                                : (SAVE_INPUT(), next = F_(srefill_)(in),      \
+                                   LOAD_INPUT(), next), ++counter)
+#endif
 
-#if !SCANF_DISABLE_SUPPORT_SCANSET
+#undef GOT_EOF
+#define GOT_EOF() (IS_EOF(next))
 
-struct F_(scanset_) {
-#if SCANF_CAN_FAST_SCANSET
-    const BOOL *mask;
+#undef SKIP_SPACE
+#if SCANF_USE_SIMD
+/* skip 0-N whitespace, counting it in counter. runs of more than one
+   character go through the kernels when the input allows */
+#define SKIP_SPACE(counter) do {                                               \
+        size_t k_;                                                             \
+        while (!GOT_EOF() && F_(isspace)(next)) {                              \
+            NEXT_CHAR(counter);                                                \
+            if (!GOT_EOF() && F_(isspace)(next) && VSPAN_OK(ptr, end)) {       \
+                k_ = vspanspace_(ptr, end);                                    \
+                if (k_)                                                        \
+                    ptr += k_ - 1, counter += k_ - 1, NEXT_CHAR(counter);      \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
 #else
-    const UCHAR *set_begin;
-    const UCHAR *set_end;
+/* skip 0-N whitespace, counting it in counter */
+#define SKIP_SPACE(counter) do {                                               \
+        while (!GOT_EOF() && F_(isspace)(next))                                \
+            NEXT_CHAR(counter);                                                \
+    } while (0)
 #endif
-    BOOL invert;
-};
 
-#define STRUCT_SCANSET struct F_(scanset_)
+/* the digit loop of iaton_, inlined separately for each base so that the
+   arithmetic on base can be specialized
+    (parameters as for iaton_)
+    limit: see iaton_
+    rp: the value so far, updated
+    digitp: set to 1 if any digits were read
 
-static INLINE BOOL F_(insset_)(const struct F_(scanset_) *set, UCHAR c) {
-#if SCANF_CAN_FAST_SCANSET
-    return set->mask[c] != set->invert;
-#else
-    return F_(inscan_)(set->set_begin, set->set_end, c) != set->invert;
+    return value: 1 if the value overflowed uintmax_t, 0 if not
+*/
+static ALWAYS_INLINE BOOL F_(idigits_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, int base, uintmax_t limit,
+                uintmax_t *rp, BOOL *digitp) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    uintmax_t r = *rp;
+    /* r * base + d fits under limit if r < rmax or r == rmax, d <= dmax */
+    uintmax_t rmax = limit / base;
+    int d, dmax = (int)(limit % base);
+    BOOL ovf = 0;
+#if SCANF_USE_SWAR
+    size_t k;
+#endif
+    LOAD_INPUT();
+
+#if SCANF_USE_SWAR
+    /* contiguous input is converted a word of digits at a time. short
+       numbers are not worth the call, so look for a whole word of digits
+       first (each character can be read if the one before it was not a null
+       character) */
+    if (KEEP_READING() && (!end || (size_t)(end - ptr) >= SWORD)) {
+        for (k = 1; k < SWORD && sisdigr_(ptr[k], base); ++k)
+            ;
+    } else
+        k = 0;
+    if (k == SWORD) {
+        k = maxlen - nowread;
+        if (end && k > (size_t)(end - ptr))
+            k = (size_t)(end - ptr);
+        k = sdigits_(ptr, k, !end, base, &r);
+        if (k) {
+            *digitp = 1;
+            ptr += k - 1, nowread += k - 1;
+            NEXT_CHAR(nowread);
+        }
+    }
 #endif
-}
 
-#else /* !SCANF_DISABLE_SUPPORT_SCANSET */
-
-#define STRUCT_SCANSET void
+    /* read digits and convert to integer */
+    while (KEEP_READING() && (d = F_(ctovn_)(next, base)) < base) {
+        *digitp = 1;
+        if (r < rmax || (r == rmax && d <= dmax))
+            r = r * base + d;
+        else if (limit != UINTMAX_MAX)
+            /* the value is clamped to less than this anyway */
+            r = limit + 1;
+        else
+            ovf = 1;
+        NEXT_CHAR(nowread);
+    }
 
-#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+    *rp = r;
+    return ovf;
+}
 
-/* read char(s)/string from stream without char conversion
-    getch: stream read function
-    p: pointer to pass to above
-    nextc: pointer to next character in buffer
+#if SCANF_GROUPING
+/* read a digit group separator that follows a group of n digits, if another
+   group can follow it. the first group must have one to three digits and
+   the rest exactly three. the separator cannot be unread, so with input in
+   memory, the group after it is looked at first, and the separator is left
+   unread unless exactly three digits follow it (or the width ends the
+   number after three). the window of a stream may end before that can be
+   told; the separator is then read, and the caller must make the number
+   invalid if the group after it is not three digits
+    in: input source
+    nextc: pointer to next character in buffer, at the separator
     readin: pointer to number of characters read
     maxlen: value that *readin should be at most
-    ctype: one of the values of iscans_type
-    set: a struct scanset_, only used with A_SCANSET
-    nostore: whether nostore was specified
-    outp: output CHAR pointer (not dereferenced if nostore=1)
+    base: 10 for decimal, etc.
+    n: number of digits in the group before the separator
+    more: whether that group came after a separator
 
-    return value: 1 if conversion OK, 0 if not
+    return value: 1 if the separator was read, 0 if not
 */
-static INLINE BOOL F_(iscans_)(CINT (*getch)(void *p), void *p, CINT *nextc,
-                    size_t *readin, size_t maxlen, enum iscans_type ctype,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                    const STRUCT_SCANSET *set,
-#endif
-                    BOOL nostore, CHAR *outp) {
+static NOINLINE BOOL F_(igsep_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, int base, size_t n,
+                BOOL more) {
     CINT next = *nextc;
-    size_t nowread = *readin;
-
-    while (KEEP_READING()) {
-        if (ctype == A_STRING && F_(isspace)(next))
-            break;
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-        if (ctype == A_SCANSET && !F_(insset_)(set, (UCHAR)next))
-            break;
-#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
-        if (!nostore) *outp++ = (CHAR)(UCHAR)next;
-        NEXT_CHAR(nowread);
+    size_t nowread = *readin, k;
+    const UCHAR *ptr, *end;
+
+    if (next != GSEP_ || maxlen - nowread < 4 || (more ? n != 3 : !n || n > 3))
+        return 0;
+    LOAD_INPUT();
+    /* the separator and three digits fit in the width; the fourth
+       character after it only matters if it does too */
+    for (k = 1; k <= 4 && nowread + k < maxlen; ++k) {
+        BOOL digit;
+        if (end && ptr + k >= end) {
+            /* the window ends here. a buffer ends with it, but a stream
+               may go on */
+            if (in->kind != SI_BUFFER)
+                break;
+            digit = 0;
+        } else
+            /* strings end at a null character, which is not a digit */
+            digit = F_(ctovn_)((CINT)ptr[k], base) < base;
+        if (digit != (k < 4))
+            return 0;
     }
 
+    NEXT_CHAR(nowread);
+    SAVE_INPUT();
     *nextc = next;
     *readin = nowread;
-    switch (ctype) {
-    case A_CHAR:
-        if (nowread < maxlen)
-            return 0;
-        break;
-    case A_STRING:
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-    case A_SCANSET:
-#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
-        if (!nowread)
-            return 0;
-        if (!nostore)
-            *outp = C_('\0');
-#if SCANF_DISABLE_SUPPORT_SCANSET
-    default: ; /* inhibit compiler warning for missing case for enum */
-#endif
-    }
     return 1;
 }
 
-#if SCANF_WIDE_CONVERT
-#undef CVTCHAR
-#if SCANF_WIDE
-#define CVTCHAR char
-#else
-#define CVTCHAR WCHAR
-#endif
+/* read the digit groups that follow the digits read so far, each after a
+   separator, like idigits_. separators are read as by igsep_
+    (parameters as for idigits_)
+    lead: number of digits in the first group, the one read so far
 
-/* read char(s)/string from stream with conversion
-    getch: stream read function
-    p: pointer to pass to above
+    return value: 1 if the value overflowed, else 0. *digitp is set to 0 if
+                  a separator was read but the group after it was not valid
+*/
+static NOINLINE BOOL F_(igroups_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, int base, uintmax_t limit,
+                size_t lead, uintmax_t *rp, BOOL *digitp) {
+    CINT next = *nextc;
+    size_t nowread = *readin, n = lead;
+    BOOL ovf = 0, more = 0;
+
+    while (F_(igsep_)(in, &next, &nowread, maxlen, base, n, more)) {
+        size_t k = nowread;
+        ovf |= F_(idigits_)(in, &next, &nowread, maxlen, base, limit,
+                            rp, digitp);
+        n = nowread - k, more = 1;
+        if (n != 3) {
+            *digitp = 0;
+            break;
+        }
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return ovf;
+}
+#endif /* SCANF_GROUPING */
+
+/* convert stream to integer
+    in: input source
     nextc: pointer to next character in buffer
     readin: pointer to number of characters read
     maxlen: value that *readin should be at most
-    ctype: one of the values of iscans_type
-    set: a struct scanset_, only used with A_SCANSET
-    nostore: whether nostore was specified
-    outp: output pointer of the other char type (not dereferenced if nostore=1)
+    base: 10 for decimal, 16 for hexadecimal, etc.
+    unsign: whether the result should be unsigned
+    negative: whether there was a - sign
+    zero: if no digits, allow zero (i.e. read zero before iaton_)
+    group: whether digit group separators are allowed (the ' flag)
+    limit: UINTMAX_MAX, or any value above which the result will be clamped
+           to the same value as if it were limit + 1; digits past that point
+           are then no longer converted
+    dest: intmax_t* or uintmax_t*, where result is stored
 
     return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified)
 */
-static INLINE BOOL F_(iscvts_)(CINT (*getch)(void *p), void *p, CINT *nextc,
-                    size_t *readin, size_t maxlen, enum iscans_type ctype,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                    const STRUCT_SCANSET *set,
+static ALWAYS_INLINE BOOL F_(iaton_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, int base, BOOL unsign,
+                BOOL negative, BOOL zero, BOOL group, uintmax_t limit,
+                void *dest) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    uintmax_t r = 0;
+    /* read digits? overflow? */
+    BOOL digit = 0, ovf = 0;
+
+#if SCANF_MINIMIZE
+    ovf = F_(idigits_)(in, &next, &nowread, maxlen, base, limit, &r, &digit);
+#else
+    {
+        const UCHAR *ptr, *end;
+        LOAD_INPUT();
+        /* skip initial zeros */
+        while (KEEP_READING() && next == C_('0')) {
+            digit = 1;
+            NEXT_CHAR(nowread);
+        }
+        SAVE_INPUT();
+    }
+
+    switch (base) {
+    case 8:
+        ovf = F_(idigits_)(in, &next, &nowread, maxlen, 8, limit, &r, &digit);
+        break;
+    case 16:
+        ovf = F_(idigits_)(in, &next, &nowread, maxlen, 16, limit, &r, &digit);
+        break;
+#if SCANF_BINARY
+    case 2:
+        ovf = F_(idigits_)(in, &next, &nowread, maxlen, 2, limit, &r, &digit);
+        break;
+#endif
+    default: /* 10 */
+        ovf = F_(idigits_)(in, &next, &nowread, maxlen, 10, limit, &r, &digit);
+    }
+#endif
+
+#if SCANF_GROUPING
+    if (group && (digit || zero) && next == GSEP_)
+        ovf |= F_(igroups_)(in, &next, &nowread, maxlen, base, limit,
+                            nowread - *readin + (zero != 0), &r, &digit);
+#else
+    (void)group;
+#endif
+
+    /* if no digits read? */
+    if (digit) {
+        /* overflow detection, negation, etc. */
+        if (unsign) {
+#if SCANF_CLAMP
+            if (negative)
+                r = 0;
+            else if (ovf)
+                r = (intmax_t)UINTMAX_MAX;
+#else
+            if (ovf)
+                r = (intmax_t)UINTMAX_MAX;
+            else if (negative)
+                r = (uintmax_t)-r;
+#endif
+            *(uintmax_t *)dest = r;
+        } else {
+            intmax_t sr;
+            if (ovf || (negative ? (intmax_t)r < 0
+                                 : r > (uintmax_t)INTMAX_MAX))
+                sr = negative ? INTMAX_MIN : INTMAX_MAX;
+            else {
+                sr = negative ? -(intmax_t)r : (intmax_t)r;
+            }
+            *(intmax_t *)dest = sr;
+        }
+    } else if (zero) {
+        if (unsign)
+            *(uintmax_t *)dest = 0;
+        else
+            *(intmax_t *)dest = 0;
+        digit = 1;
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return digit;
+}
+
+#if SCANF_USE_INT128
+#ifndef SCANF_REPEAT
+__extension__ typedef unsigned __int128 su128_;
 #endif
-                    BOOL nostore, CVTCHAR *outp) {
+
+/* convert stream to a 128-bit integer, like iaton_ but without a limit.
+   this is its own function so that the 64-bit path stays as it is
+    (parameters as for iaton_)
+    dest: su128_*, where the result is stored (as two's complement if
+          signed), or NULL to not store it
+
+    return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified)
+*/
+static NOINLINE BOOL F_(iaton128_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, int base, BOOL unsign,
+                BOOL negative, BOOL zero, BOOL group, void *dest) {
     CINT next = *nextc;
-    size_t nowread = *readin, mbr;
-    scanf_mbstate_t mbstate;
-#if SCANF_WIDE
-    char tmp[MB_LEN_MAX];
-    if (nostore)
-        outp = tmp;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    su128_ r = 0, v;
+    /* the largest magnitude that can be stored */
+    su128_ max = unsign ? ~(su128_)0 : (~(su128_)0 >> 1) + (negative != 0);
+    /* digits in a chunk that always fits in uintmax_t, and their bits */
+    size_t cap = base == 10 ? 19 : base == 16 ? 16 : base == 8 ? 21 : 64;
+    int bits = base == 16 ? 4 : base == 8 ? 3 : 1;
+    BOOL digit = 0, ovf = 0;
+#if SCANF_GROUPING
+    /* where the digit group being read starts; read a separator? */
+    size_t gs = nowread;
+    BOOL gm = 0;
 #else
-    char nc;
-    WCHAR tmp;
-    if (nostore)
-        outp = &tmp;
+    (void)group;
 #endif
 
-    mbsetup_(&mbstate);
-    while (KEEP_READING()) {
-        if (ctype == A_STRING && F_(isspace)(next))
+    LOAD_INPUT();
+    /* skip initial zeros */
+    while (KEEP_READING() && next == C_('0')) {
+        digit = 1;
+        NEXT_CHAR(nowread);
+    }
+    SAVE_INPUT();
+
+    for (;;) {
+        uintmax_t w = 0, p = 1;
+        size_t k = nowread, n = maxlen - nowread > cap ? nowread + cap
+                                                        : maxlen;
+        switch (base) {
+        case 8:
+            F_(idigits_)(in, &next, &nowread, n, 8, UINTMAX_MAX, &w, &digit);
             break;
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-        if (ctype == A_SCANSET && !F_(insset_)(set, (UCHAR)next))
+        case 16:
+            F_(idigits_)(in, &next, &nowread, n, 16, UINTMAX_MAX, &w, &digit);
             break;
-#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
-#if SCANF_WIDE
-        /* wide => narrow */
-        mbr = wcrtomb_(outp, next, &mbstate);
-        if (mbr == (size_t)(-1)) {
+#if SCANF_BINARY
+        case 2:
+            F_(idigits_)(in, &next, &nowread, n, 2, UINTMAX_MAX, &w, &digit);
+            break;
+#endif
+        default: /* 10 */
+            F_(idigits_)(in, &next, &nowread, n, 10, UINTMAX_MAX, &w, &digit);
+        }
+        k = nowread - k;
+        if (!k) {
+#if SCANF_GROUPING
+            /* a separator after a digit group, if another one follows */
+            if (group && (digit || zero)
+                      && F_(igsep_)(in, &next, &nowread, maxlen, base,
+                                    nowread - gs + (!gm && zero), gm)) {
+                gs = nowread, gm = 1;
+                continue;
+            }
+#endif
+            break;
+        }
+        if (ovf)
+            continue;
+
+        /* r = r * base^k + w, if that fits */
+        if (base == 10) {
+            su128_ lo, hi;
+            while (k--)
+                p *= 10;
+            lo = (su128_)(uintmax_t)r * p;
+            hi = (su128_)(uintmax_t)(r >> 64) * p + (lo >> 64);
+            if (hi >> 64)
+                ovf = 1;
+            else
+                r = (hi << 64 | (uintmax_t)lo) + w;
+            if (r < w)
+                ovf = 1;
+        } else {
+            /* at most 64 bits at a time */
+            k *= bits;
+            if (r >> (127 - k) >> 1)
+                ovf = 1;
+            else
+                r = r << k | w;
+        }
+        if (r > max)
+            ovf = 1;
+    }
+#if SCANF_GROUPING
+    /* a separator was read, but the group after it was not valid */
+    if (gm && nowread - gs != 3)
+        digit = 0;
+#endif
+
+    if (digit) {
+        /* overflow detection, negation, etc. as in iaton_ */
+        if (!ovf)
+            v = negative ? -r : r;
+        else
+            v = negative && !unsign ? -max : max;
+#if SCANF_CLAMP
+        if (unsign && negative)
+            v = 0;
+#endif
+        if (dest)
+            *(su128_ *)dest = v;
+    } else if (zero) {
+        if (dest)
+            *(su128_ *)dest = 0;
+        digit = 1;
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return digit;
+}
+#endif /* SCANF_USE_INT128 */
+
+#if SCANF_FIXED_POINT
+/* convert stream to a fixed-point decimal, as an integer scaled by
+   10^scale. digits past those are rounded off, half to even
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    scale: number of digits after the decimal point to keep
+    negative: whether there was a - sign
+    group: whether digit group separators are allowed (the ' flag)
+    dest: intmax_t*, where result is stored
+
+    return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified)
+*/
+static NOINLINE BOOL F_(iatofx_)(struct F_(sinput_) *in, CINT *nextc,
+                size_t *readin, size_t maxlen, size_t scale,
+                BOOL negative, BOOL group, intmax_t *dest) {
+    CINT next = *nextc;
+    size_t nowread = *readin, k = 0;
+    const UCHAR *ptr, *end;
+    /* the largest magnitude, over which the result saturates */
+    uintmax_t r = 0, limit = (uintmax_t)INTMAX_MAX + (negative != 0);
+    /* read digits? the first dropped digit and any nonzero one after it */
+    BOOL digit = 0, sticky = 0;
+    int d = 0;
+
+    LOAD_INPUT();
+    /* skip initial zeros */
+    while (KEEP_READING() && next == C_('0')) {
+        digit = 1;
+        NEXT_CHAR(nowread);
+    }
+    SAVE_INPUT();
+    /* the integer part, and then the kept digits of the fraction are
+       converted like one integer */
+    F_(idigits_)(in, &next, &nowread, maxlen, 10, limit, &r, &digit);
+#if SCANF_GROUPING
+    if (group && digit && next == GSEP_) {
+        F_(igroups_)(in, &next, &nowread, maxlen, 10, limit,
+                     nowread - *readin, &r, &digit);
+        if (!digit) {
             *nextc = next;
             *readin = nowread;
             return 0;
         }
-        else if (mbr > 0 && !nostore)
-            outp += mbr;
+    }
 #else
-        /* narrow => wide */
-        nc = (char)next;
-        mbr = mbrtowc_(outp, &nc, 1, &mbstate);
-        if (mbr == (size_t)(-1)) {
-            *nextc = next;
-            *readin = nowread;
-            return 0;
+    (void)group;
+#endif
+    LOAD_INPUT();
+    if (KEEP_READING() && next == C_('.')) {
+        size_t n;
+        NEXT_CHAR(nowread);
+        n = maxlen - nowread > scale ? nowread + scale : maxlen;
+        k = nowread;
+        SAVE_INPUT();
+        F_(idigits_)(in, &next, &nowread, n, 10, limit, &r, &digit);
+        LOAD_INPUT();
+        k = nowread - k;
+        if (KEEP_READING() && F_(isdigit)(next)) {
+            d = F_(ctodn_)(next);
+            digit = 1;
+            NEXT_CHAR(nowread);
+            while (KEEP_READING() && F_(isdigit)(next)) {
+                if (next != C_('0'))
+                    sticky = 1;
+                NEXT_CHAR(nowread);
+            }
         }
-        else if (mbr != (size_t)(-2) && !nostore)
-            ++outp;
+    }
+    SAVE_INPUT();
+
+    if (digit) {
+        intmax_t sr;
+        /* pad the fraction to scale digits */
+        for (; k < scale && r && r <= limit; ++k)
+            r = r <= limit / 10 ? r * 10 : limit + 1;
+        if (d > 5 || (d == 5 && (sticky || (r & 1))))
+            ++r;
+        if (r > limit)
+            r = limit;
+        if (!negative)
+            sr = (intmax_t)r;
+        else if (r > (uintmax_t)INTMAX_MAX)
+            sr = INTMAX_MIN;
+        else
+            sr = -(intmax_t)r;
+        *dest = sr;
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return digit;
+}
+#endif /* SCANF_FIXED_POINT */
+
+#ifndef SCANF_REPEAT
+/* enum for possible data types */
+enum dlength { LN_, LN_hh, LN_h, LN_l, LN_ll, LN_L, LN_j, LN_z, LN_t,
+               LN_H, LN_B, LN_w128, LN_v, LN_k, LN_y, LN_kw };
+
+#if !SCANF_DISABLE_SUPPORT_FLOAT
+/* the result of a float conversion, as the type it is stored as */
+union sfloat_ {
+    float f;
+    double d;
+    floatmax_t l;
+#if SCANF_USE_FLOAT16
+    unsigned short h;   /* LN_H and LN_B: the bits of the 16-bit float */
+#endif
+};
+
+/* store v as the type given by dlen (see iatof_) */
+static void fstore_(union sfloat_ *r, enum dlength dlen, floatmax_t v) {
+    switch (dlen) {
+    case LN_L:
+        r->l = v;
+        break;
+    case LN_l:
+        r->d = (double)v;
+        break;
+#if SCANF_USE_FLOAT16
+    case LN_H:
+    case LN_B:
+    {
+        /* only infinities and NaNs are stored here, and those keep the sign
+           and quiet bit of the float */
+        union { float f; unsigned u; } x;
+        x.f = (float)v;
+        if (dlen == LN_B)
+            r->h = (unsigned short)(x.u >> 16);
+        else
+            r->h = (unsigned short)(((x.u >> 16) & 0x8000U) | 0x7C00U
+                                    | ((x.u >> 13) & 0x3FFU));
+        break;
+    }
+#endif
+    default:
+        r->f = (float)v;
+    }
+}
+#endif /* !SCANF_DISABLE_SUPPORT_FLOAT */
+#endif /* SCANF_REPEAT */
+
+#if !SCANF_DISABLE_SUPPORT_FLOAT
+/* read the exponent of a float, if there is one
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    hex: whether in hex mode (p instead of e)
+    exp: intmax_t*, where the exponent is stored if there is one
+
+    return value: 0 if there was an exponent character but no exponent
+*/
+static INLINE BOOL F_(iatoe_)(struct F_(sinput_) *in, CINT *nextc,
+                              size_t *readin, size_t maxlen, BOOL hex,
+                              intmax_t *exp) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    BOOL ok = 1;
+    /* exponent character */
+    CHAR expuc = hex ? 'P' : 'E', explc = hex ? 'p' : 'e';
+    LOAD_INPUT();
+
+    if (KEEP_READING() && (next == explc || next == expuc)) {
+        BOOL eneg = 0;
+        NEXT_CHAR(nowread);
+        if (KEEP_READING()) {
+            switch (next) {
+            case C_('-'):
+                eneg = 1;
+                /* fall-through */
+            case C_('+'):
+                NEXT_CHAR(nowread);
+            }
+        }
+
+        SAVE_INPUT();
+        ok = F_(iaton_)(in, &next, &nowread, maxlen, 10,
+                        0, eneg, 0, 0, UINTMAX_MAX, exp);
+        LOAD_INPUT();
+    }
+
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+    return ok;
+}
+
+#if SCANF_USE_EXACT_FLOAT
+/* convert stream to a correctly rounded float or double
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    hex: whether in hex mode
+    negative: whether there was a - sign
+    zero: if no digits, allow zero (i.e. read zero before iatod_)
+    group: whether digit group separators are allowed before the dot
+    dlen: LN_l for double, LN_H and LN_B for binary16 and bfloat16,
+          anything else for float
+    dest: union sfloat_*, where result is stored as the type given by dlen
+
+    return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified)
+*/
+static NOINLINE BOOL F_(iatod_)(struct F_(sinput_) *in, CINT *nextc,
+                       size_t *readin, size_t maxlen, BOOL hex, BOOL negative,
+                       BOOL zero, BOOL group, enum dlength dlen,
+                       union sfloat_ *dest) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    /* decimal digits after the first 19, in case they are needed */
+    struct fdec_ dec;
+    /* the first 19 significant decimal digits or 16 hex digits */
+    uintmax_t w = 0;
+    /* significant digits; those before the dot; zeros between dot and them */
+    size_t nd = 0, ni = 0, nz = 0;
+    /* base; how many digits fit in w */
+    int base = hex ? 16 : 10, wd = hex ? 16 : 19;
+    intmax_t exp = 0;
+    /* saw dot? saw digit? nonzero digits that did not fit in w? */
+    BOOL dot = 0, digit = zero, trunc = 0;
+    int c;
+#if SCANF_GROUPING
+    /* where the digit group being read starts; read a separator? was the
+       group after one not valid? */
+    size_t gs = nowread;
+    BOOL gm = 0, gbad = 0;
+#else
+    (void)group;
+#endif
+    LOAD_INPUT();
+
+    while (KEEP_READING() && next == C_('0')) {
+        digit = 1;
+        NEXT_CHAR(nowread);
+    }
+#if SCANF_GROUPING
+leadzeros:
+    /* a group of only zeros may end at the dot */
+    if (gm && KEEP_READING() && next == C_('.') && nowread - gs != 3)
+        gbad = 1;
+#endif
+    if (KEEP_READING() && next == C_('.')) {
+        dot = 1;
+        NEXT_CHAR(nowread);
+        while (KEEP_READING() && next == C_('0')) {
+            digit = 1;
+            ++nz;
+            NEXT_CHAR(nowread);
+        }
+    }
+
+    dec.trunc = 0;
+    for (;;) {
+        /* the digits that fit in w are converted like integers */
+        if (nd < (size_t)wd) {
+            size_t k = nowread, n = maxlen - nowread > wd - nd
+                                  ? nowread + wd - nd : maxlen;
+            SAVE_INPUT();
+            if (hex)
+                F_(idigits_)(in, &next, &nowread, n, 16, UINTMAX_MAX,
+                             &w, &digit);
+            else
+                F_(idigits_)(in, &next, &nowread, n, 10, UINTMAX_MAX,
+                             &w, &digit);
+            LOAD_INPUT();
+            nd += nowread - k;
+        }
+        /* and the rest are only kept for the slow path */
+        while (KEEP_READING() && (c = F_(ctovn_)(next, base)) < base) {
+            if (c) {
+                trunc = 1;
+                if (nd >= FDEC_DIGITS)
+                    dec.trunc = 1;
+            }
+            if (nd < FDEC_DIGITS)
+                dec.d[nd] = (unsigned char)c;
+            ++nd;
+            NEXT_CHAR(nowread);
+        }
+#if SCANF_GROUPING
+        /* a separator after a digit group, if another one follows */
+        if (group && !dot && digit) {
+            BOOL sep;
+            SAVE_INPUT();
+            sep = F_(igsep_)(in, &next, &nowread, maxlen, base,
+                             nowread - gs + (!gm && zero), gm);
+            LOAD_INPUT();
+            if (sep) {
+                gs = nowread, gm = 1;
+                if (!nd) {
+                    /* more leading zeros, which are not significant */
+                    while (KEEP_READING() && next == C_('0'))
+                        NEXT_CHAR(nowread);
+                    goto leadzeros;
+                }
+                continue;
+            }
+            if (gm && nowread - gs != 3) {
+                gbad = 1;
+                break;
+            }
+        }
+#endif
+        if (dot || !KEEP_READING() || next != C_('.'))
+            break;
+        dot = 1;
+        ni = nd;
+        NEXT_CHAR(nowread);
+    }
+    if (!dot)
+        ni = nd;
+    if (nd)
+        digit = 1;
+#if SCANF_GROUPING
+    if (gbad)
+        digit = 0;
+#endif
+
+    SAVE_INPUT();
+    if (digit && !F_(iatoe_)(in, &next, &nowread, maxlen, hex, &exp))
+        digit = 0;
+
+    if (digit) {
+        intmax_t dp, q;
+        /* keep the sums from overflowing; exponents anywhere near this
+           large are out of range anyway */
+        if (exp > INTMAX_MAX / 16)
+            exp = INTMAX_MAX / 16;
+        else if (exp < -(INTMAX_MAX / 16))
+            exp = -(INTMAX_MAX / 16);
+        dp = (intmax_t)ni - (intmax_t)nz;
+        q = dp - (intmax_t)(nd < (size_t)wd ? nd : (size_t)wd);
+
+        if (hex) {
+            /* w * 2^q, with a binary exponent */
+            q = q * 4 + exp;
+        } else {
+            dp += exp;
+            q += exp;
+            dec.nd = nd < FDEC_DIGITS ? (int)nd : FDEC_DIGITS;
+            dec.dp = dp < -9999 ? -9999 : dp > 9999 ? 9999 : (int)dp;
+        }
+
+        switch (dlen) {
+        case LN_l:
+            dest->d = hex ? fbtod_(fxbits_(&fbin64_, w, q, trunc))
+                          : ftod_(w, q, trunc, &dec);
+            if (negative) dest->d = -dest->d;
+            break;
+#if SCANF_USE_FLOAT16
+        case LN_H:
+        case LN_B:
+        {
+            /* there is no fast path, since the float and double
+               operations would round twice */
+            const struct ffmt_ *f = dlen == LN_H ? &fbin16_ : &fbf16_;
+            dest->h = (unsigned short)(hex ? fxbits_(f, w, q, trunc)
+                                           : ftobits_(f, w, q, trunc, &dec));
+            if (negative) dest->h |= 0x8000U;
+            break;
+        }
+#endif
+        default:
+            dest->f = hex ? fbtof_(fxbits_(&fbin32_, w, q, trunc))
+                          : ftof_(w, q, trunc, &dec);
+            if (negative) dest->f = -dest->f;
+        }
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return digit;
+}
+#endif /* SCANF_USE_EXACT_FLOAT */
+
+/* convert stream to floating point
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    hex: whether in hex mode
+    negative: whether there was a - sign
+    zero: if no digits, allow zero (i.e. read zero before iatof_)
+    group: whether digit group separators are allowed before the dot
+    dlen: LN_L for long double, LN_l for double, LN_H and LN_B for binary16
+          and bfloat16, anything else for float
+    dest: union sfloat_*, where result is stored as the type given by dlen
+
+    return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified)
+*/
+static INLINE BOOL F_(iatof_)(struct F_(sinput_) *in, CINT *nextc,
+                       size_t *readin, size_t maxlen, BOOL hex, BOOL negative,
+                       BOOL zero, BOOL group, enum dlength dlen,
+                       union sfloat_ *dest) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    floatmax_t r = 0, pr = 0;
+    /* saw dot? saw digit? was there an overflow? */
+    BOOL dot = 0, digit = 0, ovf = 0;
+    /* exponent, offset (with decimals, etc.) */
+    intmax_t exp = 0, off = 0;
+    /* how much to subtract from off with every digit */
+    int sub = 0;
+    /* base */
+    int base = hex ? 16 : 10;
+#if SCANF_GROUPING
+    /* where the digit group being read starts; read a separator? */
+    size_t gs = nowread;
+    BOOL gm = 0;
+#else
+    (void)group;
+#endif
+
+#if SCANF_USE_EXACT_FLOAT
+    /* the float engine rounds to float and double, but long double may be
+       wider than either */
+    if (dlen != LN_L)
+        return F_(iatod_)(in, nextc, readin, maxlen, hex, negative, zero,
+                          group, dlen, dest);
+#endif
+    LOAD_INPUT();
+
+#if !SCANF_MINIMIZE
+    while (KEEP_READING() && next == C_('0')) {
+        digit = 1;
+        NEXT_CHAR(nowread);
+    }
+#endif
+
+    /* read digits and convert */
+    while (KEEP_READING()) {
+        if (F_(isdigr_)(next, base)) {
+            if (!ovf) {
+                digit = 1;
+                r = r * base + F_(ctorn_)(next, base);
+                if (r > 0 && pr == r) {
+                    ovf = 1;
+                } else {
+                    pr = r;
+                    off += sub;
+                }
+            }
+        } else if (next == C_('.')) {
+            if (dot)
+                break;
+#if SCANF_GROUPING
+            /* the last group ends at the dot */
+            if (gm && nowread - gs != 3)
+                break;
+#endif
+            dot = 1, sub = hex ? 4 : 1;
+#if SCANF_GROUPING
+        } else if (group && !dot && (digit || zero) && next == GSEP_) {
+            /* a separator after a digit group, if another one follows */
+            BOOL sep;
+            SAVE_INPUT();
+            sep = F_(igsep_)(in, &next, &nowread, maxlen, base,
+                             nowread - gs + (!gm && zero), gm);
+            LOAD_INPUT();
+            if (!sep)
+                break;
+            gs = nowread, gm = 1;
+            continue;
+#endif
+        } else
+            break;
+        NEXT_CHAR(nowread);
+    }
+
+    if (zero && !digit)
+        digit = 1;
+        /* r == 0 should already apply */
+#if SCANF_GROUPING
+    /* a separator was read, but the group after it was not valid */
+    if (gm && !dot && nowread - gs != 3)
+        digit = 0;
+#endif
+
+    SAVE_INPUT();
+    if (digit && !F_(iatoe_)(in, &next, &nowread, maxlen, hex, &exp))
+        digit = 0;
+    LOAD_INPUT();
+
+    if (digit) {
+        if (dot) {
+            intmax_t oexp = exp;
+            exp -= off;
+            if (exp > oexp) exp = INTMAX_MIN; /* underflow protection */
+        }
+
+        if (r != 0) {
+            if (exp > 0) {
+#ifdef INFINITY
+#if FLT_RADIX == 2
+                if (exp > (hex ? LDBL_MAX_EXP : LDBL_MAX_10_EXP))
+#else
+                /* FLT_RADIX > 2 means LDBL_MAX_EXP is defined as e
+                    in b^e for some b > 2; we'd need to compute
+                    LDBL_MAX_EXP * log(b) / log(2)
+                    at compile time, which is hardly an option.
+                    so instead we'll do the next best thing */
+                if (exp > (hex ? (LDBL_MAX_EXP * FLT_RADIX + 1)
+                                : LDBL_MAX_10_EXP))
+#endif
+                    r = INFINITY;
+                else
+#endif
+                    r *= powi_(hex ? 2 : 10, exp);
+            } else if (exp < 0) {
+#if FLT_RADIX == 2
+                if (exp < (hex ? LDBL_MIN_EXP : LDBL_MIN_10_EXP))
+#else
+                if (exp < (hex ? (LDBL_MIN_EXP * FLT_RADIX - 1)
+                                : LDBL_MIN_10_EXP))
+#endif
+                    r = 0;
+                else
+                    r /= powi_(hex ? 2 : 10, -exp);
+            }
+        }
+
+        if (negative) r = -r;
+        fstore_(dest, dlen, r);
+    }
+
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+    return digit;
+}
+#endif /* !SCANF_DISABLE_SUPPORT_FLOAT */
+
+#ifndef SCANF_REPEAT
+enum iscans_type { A_CHAR, A_STRING, A_SCANSET };
+
+/* escapes decoded by %U and %Q */
+enum idecode_type { E_NONE, E_URL, E_C };
+
+/* memory being allocated for %m, which grows as it is written to */
+struct sgrow_ {
+    unsigned char *buf;
+    /* bytes allocated; bytes written, once done */
+    size_t cap, len;
+};
+
+#if SCANF_ALLOC
+#if !SCANF_FREESTANDING
+/* the default allocator for %m */
+static void *sstdalloc_(void *data, void *p, size_t oldsize, size_t size) {
+    (void)data, (void)oldsize;
+    if (size)
+        return realloc(p, size);
+    free(p);
+    return NULL;
+}
+#define SSTDALLOC_ &sstdalloc_
+#else
+/* there is none without the standard library; %m fails until one is set */
+#define SSTDALLOC_ NULL
+#endif
+
+/* the allocator for %m on this thread, see scanf_set_allocator_ */
+static SCANF_THREAD_LOCAL void *(*salloc_)(void *data, void *p,
+                                           size_t oldsize, size_t size)
+                                = SSTDALLOC_;
+static SCANF_THREAD_LOCAL void *sallocdata_ = NULL;
+
+void scanf_set_allocator_(void *(*resize)(void *data, void *p,
+                                          size_t oldsize, size_t size),
+                          void *data) {
+    salloc_ = resize ? resize : SSTDALLOC_;
+    sallocdata_ = data;
+}
+
+/* make room for at least size bytes in g. the allocation at least doubles
+   every time, so that long fields are not copied over and over again */
+static BOOL sgrow_(struct sgrow_ *g, size_t size) {
+    size_t cap = g->cap ? g->cap : size;
+    void *p;
+    if (size <= g->cap)
+        return 1;
+    while (cap < size)
+        cap = cap <= SIZE_MAX / 2 ? cap * 2 : size;
+    p = salloc_(sallocdata_, g->buf, g->cap, cap);
+    if (!p)
+        return 0;
+    g->buf = (unsigned char *)p, g->cap = cap;
+    return 1;
+}
+
+/* characters allocated at first for %ms and %m[ */
+#define SALLOC_FIRST 32
+
+#if SCANF_USE_INTERN
+/* make room for at least size bytes in p, which has *cap, with the allocator
+   of a dictionary. like sgrow_, the memory at least doubles every time
+
+   return value: the memory, or NULL if it could not be grown (p is then
+                 still valid)
+*/
+static void *sdgrow_(void *(*resize)(void *data, void *p, size_t oldsize,
+                                     size_t size),
+                     void *data, void *p, size_t *cap, size_t size) {
+    size_t n = *cap ? *cap : 64;
+    if (size <= *cap)
+        return p;
+    while (n < size)
+        n = n <= SIZE_MAX / 2 ? n * 2 : size;
+    p = resize(data, p, *cap, n);
+    if (p)
+        *cap = n;
+    return p;
+}
+#endif /* SCANF_USE_INTERN */
+#endif /* SCANF_ALLOC */
+
+#if SCANF_SINK
+/* characters sent to a %k sink at a time, where they have to be copied */
+#define SSINK_CHUNK 256
+#endif
+#endif /* SCANF_REPEAT */
+
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+
+struct F_(scanset_) {
+#if SCANF_CAN_FAST_SCANSET
+    /* SSET_WORDS words, bit c set if c is listed */
+    const unsigned *mask;
+#endif
+#if !SCANF_CAN_FAST_SCANSET || SCANF_SCANSET_HIGH
+    const UCHAR *set_begin;
+    const UCHAR *set_end;
+#endif
+    BOOL invert;
+};
+
+#define STRUCT_SCANSET struct F_(scanset_)
+
+static INLINE BOOL F_(insset_)(const struct F_(scanset_) *set, UCHAR c) {
+#if SCANF_CAN_FAST_SCANSET
+#if SCANF_SCANSET_HIGH
+    if (c >= SSET_SIZE)
+        return F_(inscan_)(set->set_begin, set->set_end, c) != set->invert;
+#endif
+    return ((set->mask[c / SSET_WBITS] >> (c % SSET_WBITS)) & 1)
+                != (unsigned)set->invert;
+#else
+    return F_(inscan_)(set->set_begin, set->set_end, c) != set->invert;
+#endif
+}
+
+#else /* !SCANF_DISABLE_SUPPORT_SCANSET */
+
+#define STRUCT_SCANSET void
+
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+
+#if SCANF_USE_SIMD
+/* the kernel part of iscans_, kept out of line so that iscans_ itself stays
+   small enough to be inlined
+    p: the input
+    n: the most characters to read
+    string: whether p is a null-terminated string, see vspan_
+    ctype, set, nostore, outp: as for iscans_
+
+    return value: number of characters read (and stored unless nostore), or
+                  (size_t)-1 if the kernels cannot match this field
+*/
+static NOINLINE size_t vscans_(const unsigned char *p, size_t n, BOOL string,
+                    enum iscans_type ctype, const STRUCT_SCANSET *set,
+                    BOOL nostore, unsigned char *outp) {
+    struct vclass_ cl;
+    /* %c reads everything */
+    cl.n = 0, cl.invert = 1, cl.table = 0;
+    if (ctype == A_STRING) /* %s everything but whitespace */
+        vspaceclass_(&cl, 1);
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+    else if (ctype == A_SCANSET) {
+#if SCANF_CAN_FAST_SCANSET
+        vsetclass_(&cl, set->mask, set->invert);
+        if (!VCLASS_OK(&cl))
+            return (size_t)-1;
+#else
+        (void)set;
+        return (size_t)-1;
+#endif
+    }
+#else
+    (void)set;
+#endif
+    /* windows hold nothing %c could stop at */
+    if (string || ctype != A_CHAR)
+        n = vspan_(&cl, p, n, string);
+    if (!nostore)
+        vcopy_(outp, p, n);
+    return n;
+}
+#endif /* SCANF_USE_SIMD */
+
+/* read char(s)/string from stream without char conversion
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: one of the values of iscans_type
+    set: a struct scanset_, only used with A_SCANSET
+    nostore: whether nostore was specified
+    outp: output CHAR pointer (not dereferenced if nostore=1)
+
+    return value: 1 if conversion OK, 0 if not
+*/
+static ALWAYS_INLINE BOOL F_(iscans_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set,
+                    BOOL nostore, CHAR *outp) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+#if SCANF_USE_SIMD
+    BOOL vok = 1;
+    size_t k, vfrom = nowread + VBLOCK / 2;
+#endif
+#if SCANF_DISABLE_SUPPORT_SCANSET
+    (void)set;
+#endif
+
+    LOAD_INPUT();
+    while (KEEP_READING()) {
+#if SCANF_USE_SIMD
+        /* long runs of contiguous input go through the kernels, a block of
+           characters at a time. short fields are left to the loop below,
+           as setting the kernels up would cost more than it saves */
+        if (vok && nowread >= vfrom && maxlen - nowread >= VBLOCK
+                && VSPAN_OK(ptr, end)) {
+            k = maxlen - nowread;
+            if (end && k > (size_t)(end - ptr))
+                k = (size_t)(end - ptr);
+            k = vscans_(ptr, k, !end, ctype, set, nostore,
+                        (unsigned char *)outp);
+            if (k == (size_t)-1)
+                vok = 0;
+            else if (k) {
+                if (!nostore) outp += k;
+                ptr += k - 1, nowread += k - 1;
+                NEXT_CHAR(nowread);
+                /* stopped at a character not to be read? */
+                if (!end || (ctype != A_CHAR && k % VBLOCK))
+                    break;
+                continue;
+            }
+        }
+#endif
+        if (ctype == A_STRING && F_(isspace)(next))
+            break;
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+        if (ctype == A_SCANSET && !F_(insset_)(set, (UCHAR)next))
+            break;
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+        if (!nostore) *outp++ = (CHAR)(UCHAR)next;
+        NEXT_CHAR(nowread);
+    }
+
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+    switch (ctype) {
+    case A_CHAR:
+        if (nowread < maxlen)
+            return 0;
+        break;
+    case A_STRING:
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+    case A_SCANSET:
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+        if (!nowread)
+            return 0;
+        if (!nostore)
+            *outp = C_('\0');
+#if SCANF_DISABLE_SUPPORT_SCANSET
+    default: ; /* inhibit compiler warning for missing case for enum */
+#endif
+    }
+    return 1;
+}
+
+#if SCANF_DECODE
+/* the character a backslash escape (other than \x) stands for, or -1 */
+static INLINE int F_(icescape_)(CINT c) {
+    switch (c) {
+    case C_('n'):  return C_('\n');
+    case C_('t'):  return C_('\t');
+    case C_('r'):  return C_('\r');
+    case C_('\\'): return C_('\\');
+    case C_('"'):  return C_('"');
+    case C_('\''): return C_('\'');
+    default:       return -1;
+    }
+}
+
+/* write what was held back of an escape that turned out not to be one:
+   the % or backslash, and then the character after it if there was one.
+   a \x with one digit is complete, and is written as its value */
+static INLINE CHAR *F_(idecheld_)(CHAR *outp, int state, CINT lead,
+                                  CINT held, int v) {
+    if (state == 3) {
+        *outp++ = (CHAR)(UCHAR)v;
+        return outp;
+    }
+    if (state)
+        *outp++ = (CHAR)(UCHAR)lead;
+    if (state == 2)
+        *outp++ = (CHAR)(UCHAR)held;
+    return outp;
+}
+
+/* read a string or scanset like iscans_, but decode escapes in it as it is
+   copied, so that the field needs no second pass. the field is what iscans_
+   would read; an escape that is cut short by its end or by a character that
+   cannot continue it is kept as it is
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: A_STRING or A_SCANSET
+    set: a struct scanset_, only used with A_SCANSET
+    esc: E_URL for %XX, E_C for \n, \t, \r, \\, \", \' and \xNN
+    outp: output CHAR pointer
+
+    return value: 1 if conversion OK, 0 if not
+*/
+static NOINLINE BOOL F_(iscand_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set, enum idecode_type esc,
+                    CHAR *outp) {
+    CINT next = *nextc;
+    size_t nowread = *readin;
+    const UCHAR *ptr, *end;
+    /* state: 0 outside an escape, 1 after its lead character, 2 after the
+       character following that (the first digit with %, x with \) and 3
+       after the first digit of \x. v is the value of the first digit */
+    CINT lead = esc == E_URL ? C_('%') : C_('\\'), held = 0;
+    int state = 0, v = 0, x, e;
+#if SCANF_DISABLE_SUPPORT_SCANSET
+    (void)set;
+#endif
+
+    LOAD_INPUT();
+    while (KEEP_READING()) {
+        if (ctype == A_STRING && F_(isspace)(next))
+            break;
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+        if (ctype == A_SCANSET && !F_(insset_)(set, (UCHAR)next))
+            break;
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+        x = F_(ctovn_)(next, 16);
+        switch (state) {
+        case 1:
+            if (esc == E_URL ? x < 16 : next == C_('x')) {
+                held = next, v = x, state = 2;
+                break;
+            }
+            if (esc == E_C && (e = F_(icescape_)(next)) >= 0) {
+                *outp++ = (CHAR)(UCHAR)e, state = 0;
+                break;
+            }
+            outp = F_(idecheld_)(outp, state, lead, held, v), state = 0;
+            goto plain;
+        case 2:
+            if (x < 16) {
+                if (esc == E_URL)
+                    *outp++ = (CHAR)(UCHAR)(v * 16 + x), state = 0;
+                else
+                    v = x, state = 3;
+                break;
+            }
+            outp = F_(idecheld_)(outp, state, lead, held, v), state = 0;
+            goto plain;
+        case 3:
+            if (x < 16) {
+                *outp++ = (CHAR)(UCHAR)(v * 16 + x), state = 0;
+                break;
+            }
+            outp = F_(idecheld_)(outp, state, lead, held, v), state = 0;
+            /* fall-through */
+        default:
+        plain:
+            if (next == lead)
+                state = 1;
+            else
+                *outp++ = (CHAR)(UCHAR)next;
+        }
+        NEXT_CHAR(nowread);
+    }
+    outp = F_(idecheld_)(outp, state, lead, held, v);
+
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+    if (!nowread)
+        return 0;
+    *outp = C_('\0');
+    return 1;
+}
+#endif /* SCANF_DECODE */
+
+#if SCANF_WIDE_CONVERT
+#undef CVTCHAR
+#if SCANF_WIDE
+#define CVTCHAR char
+#else
+#define CVTCHAR WCHAR
+#endif
+
+/* read char(s)/string from stream with conversion
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: one of the values of iscans_type
+    set: a struct scanset_, only used with A_SCANSET
+    nostore: whether nostore was specified
+    outp: output pointer of the other char type (not dereferenced if nostore=1)
+    grow: NULL, or the allocation for %m that outp points to the start of.
+          it is grown as needed, and the number of bytes written is stored
+          in it
+
+    return value: 1 if conversion OK, 0 if not
+*/
+static INLINE BOOL F_(iscvts_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set,
+                    BOOL nostore, CVTCHAR *outp, struct sgrow_ *grow) {
+    CINT next = *nextc;
+    size_t nowread = *readin, mbr;
+    scanf_mbstate_t mbstate;
+    const UCHAR *ptr, *end;
+#if SCANF_WIDE
+    char tmp[MB_LEN_MAX];
+    if (nostore)
+        outp = tmp;
+#else
+    char nc;
+    WCHAR tmp;
+    if (nostore)
+        outp = &tmp;
+#endif
+
+#if SCANF_DISABLE_SUPPORT_SCANSET
+    (void)set;
+#endif
+
+    mbsetup_(&mbstate);
+    LOAD_INPUT();
+    while (KEEP_READING()) {
+        if (ctype == A_STRING && F_(isspace)(next))
+            break;
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+        if (ctype == A_SCANSET && !F_(insset_)(set, (UCHAR)next))
+            break;
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+#if SCANF_ALLOC
+        if (grow) {
+            /* room for the longest character and a terminator */
+            size_t off = (size_t)((unsigned char *)outp - grow->buf);
+#if SCANF_WIDE
+            if (!sgrow_(grow, off + MB_LEN_MAX + 1)) {
+#else
+            if (!sgrow_(grow, off + 2 * sizeof(WCHAR))) {
+#endif
+                SAVE_INPUT();
+                *nextc = next;
+                *readin = nowread;
+                return 0;
+            }
+            outp = (CVTCHAR *)(grow->buf + off);
+        }
+#endif
+#if SCANF_WIDE
+        /* wide => narrow */
+        mbr = wcrtomb_(outp, next, &mbstate);
+        if (mbr == (size_t)(-1)) {
+            SAVE_INPUT();
+            *nextc = next;
+            *readin = nowread;
+            return 0;
+        }
+        else if (mbr > 0 && !nostore)
+            outp += mbr;
+#else
+        /* narrow => wide */
+        nc = (char)next;
+        mbr = mbrtowc_(outp, &nc, 1, &mbstate);
+        if (mbr == (size_t)(-1)) {
+            SAVE_INPUT();
+            *nextc = next;
+            *readin = nowread;
+            return 0;
+        }
+        else if (mbr != (size_t)(-2) && !nostore)
+            ++outp;
+#endif
+        NEXT_CHAR(nowread);
+    }
+
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+#if SCANF_ALLOC
+    if (grow)
+        grow->len = (size_t)((unsigned char *)outp - grow->buf);
+#else
+    (void)grow;
+#endif
+    switch (ctype) {
+    case A_CHAR:
+        if (nowread < maxlen)
+            return 0;
+        break;
+    case A_STRING:
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+    case A_SCANSET:
+#endif
+        if (!nowread)
+            return 0;
+        if (!nostore)
+            *outp = 0;
+#if SCANF_DISABLE_SUPPORT_SCANSET
+    default: ; /* inhibit compiler warning for missing case for enum */
+#endif
+    }
+    return 1;
+}
+#endif
+
+#if SCANF_SINK
+#undef SSINK_
+#if SCANF_WIDE
+#define SSINK_ struct wscanf_sink_
+#else
+#define SSINK_ struct scanf_sink_
+#endif
+
+/* read char(s)/string from stream and send them to a sink, for %k
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: one of the values of iscans_type
+    set: a struct scanset_, only used with A_SCANSET
+    sink: where the characters are sent, NULL if nostore
+
+    return value: 1 if conversion OK, 0 if not (in which case some of the
+                  characters may already have been sent)
+*/
+static NOINLINE BOOL F_(iscank_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set, const SSINK_ *sink) {
+    CINT next = *nextc;
+    size_t nowread = *readin, from, lim;
+    /* input that is all in memory is sent as it is. anything else is
+       copied here a chunk at a time, so that memory use stays the same
+       however long the field is */
+    BOOL direct = !sink || in->kind == SI_STRING || in->kind == SI_BUFFER;
+    BOOL ok;
+    CHAR buf[SSINK_CHUNK + 1];
+
+    do {
+        const CHAR *start = direct ? (const CHAR *)in->ptr : buf;
+        from = nowread;
+        lim = direct || maxlen - nowread <= SSINK_CHUNK ? maxlen
+                                                        : nowread + SSINK_CHUNK;
+        ok = F_(iscans_)(in, &next, &nowread, lim, ctype, set, direct, buf);
+        if (ok && sink && nowread > from
+               && sink->write(sink->data, start, nowread - from))
+            ok = 0;
+    } while (ok && nowread == lim && lim != maxlen);
+
+    *nextc = next;
+    *readin = nowread;
+    return ok;
+}
+#endif /* SCANF_SINK */
+
+#if SCANF_ALLOC
+#undef ICVT_
+/* whether %m reads into the other char type, given %l */
+#if SCANF_WIDE_CONVERT && SCANF_WIDE
+#define ICVT_(wide) (!(wide))
+#elif SCANF_WIDE_CONVERT
+#define ICVT_(wide) (wide)
+#else
+#define ICVT_(wide) 0
+#endif
+
+/* read char(s)/string from stream into memory allocated for it, for %m
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: one of the values of iscans_type
+    set: a struct scanset_, only used with A_SCANSET
+    cvt: whether the characters are converted to the other char type, as
+         with iscvts_
+    dest: CHAR** (or pointer to the other char type if cvt), where the
+          allocation is stored
+
+    return value: 1 if conversion OK, 0 if not
+                  (if 0, dest guaranteed to not be modified, and nothing is
+                   left allocated)
+*/
+static NOINLINE BOOL F_(iscanm_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set, BOOL cvt, void *dest) {
+    CINT next = *nextc;
+    size_t nowread = *readin, from = nowread, size;
+    struct sgrow_ g;
+    BOOL ok;
+    void *p;
+
+    if (!salloc_)
+        return 0;
+    g.buf = NULL, g.cap = 0;
+#if SCANF_WIDE_CONVERT
+    if (cvt) {
+        size = sizeof(CVTCHAR);
+        ok = sgrow_(&g, SALLOC_FIRST * size)
+            && F_(iscvts_)(in, &next, &nowread, maxlen, ctype, set, 0,
+                           (CVTCHAR *)g.buf, &g);
+    } else
+#else
+    (void)cvt;
+#endif
+    if (ctype == A_CHAR) {
+        /* %c reads exactly maxlen characters */
+        size = sizeof(CHAR);
+        ok = sgrow_(&g, maxlen * size)
+            && F_(iscans_)(in, &next, &nowread, maxlen, A_CHAR, NULL, 0,
+                           (CHAR *)g.buf);
+        g.len = (nowread - from) * size;
+    } else {
+        /* the others start small, and read as much as fits each time,
+           leaving room for the terminator */
+        size = sizeof(CHAR);
+        ok = sgrow_(&g, (maxlen - from < SALLOC_FIRST ? maxlen - from + 1
+                                                      : SALLOC_FIRST) * size);
+        while (ok) {
+            size_t room = g.cap / size - 1 - (nowread - from);
+            size_t lim = maxlen - nowread > room ? nowread + room : maxlen;
+            ok = F_(iscans_)(in, &next, &nowread, lim, ctype, set, 0,
+                             (CHAR *)g.buf + (nowread - from));
+            if (!ok || nowread < lim || lim == maxlen)
+                break;
+            ok = sgrow_(&g, g.cap + size);
+        }
+        g.len = (nowread - from) * size;
+    }
+
+    if (ok) {
+        /* give back what was not needed */
+        size = g.len + (ctype != A_CHAR ? size : 0);
+        if (size < g.cap
+                && (p = salloc_(sallocdata_, g.buf, g.cap, size)) != NULL)
+            g.buf = (unsigned char *)p;
+#if SCANF_WIDE_CONVERT
+        if (cvt)
+            *(CVTCHAR **)dest = (CVTCHAR *)g.buf;
+        else
+#endif
+            *(CHAR **)dest = (CHAR *)g.buf;
+    } else if (g.buf)
+        salloc_(sallocdata_, g.buf, g.cap, 0);
+
+    *nextc = next;
+    *readin = nowread;
+    return ok;
+}
+#endif /* SCANF_ALLOC */
+
+#if SCANF_USE_INTERN
+#undef SDICT_
+#if SCANF_WIDE
+#define SDICT_ struct wscanf_dict_
+#else
+#define SDICT_ struct scanf_dict_
+#endif
+
+/* set up an empty dictionary, which keeps the allocator of this thread */
+static void F_(sdinit_)(SDICT_ *d) {
+    d->count = 0;
+    d->text = NULL, d->offs = NULL, d->table = NULL;
+    d->textlen = d->textcap = d->offscap = d->tablecap = 0;
+    d->resize = salloc_, d->data = sallocdata_;
+}
+
+/* free the memory of a dictionary, leaving it empty */
+static void F_(sdfree_)(SDICT_ *d) {
+    if (d->resize) {
+        if (d->text)
+            d->resize(d->data, d->text, d->textcap, 0);
+        if (d->offs)
+            d->resize(d->data, d->offs, d->offscap, 0);
+        if (d->table)
+            d->resize(d->data, d->table, d->tablecap, 0);
+    }
+    d->count = 0;
+    d->text = NULL, d->offs = NULL, d->table = NULL;
+    d->textlen = d->textcap = d->offscap = d->tablecap = 0;
+}
+
+/* FNV-1a over the characters of a string */
+static INLINE unsigned long F_(sdhash_)(const CHAR *s, size_t n) {
+    unsigned long h = 2166136261UL;
+    size_t i;
+    for (i = 0; i < n; ++i)
+        h = ((h ^ (unsigned long)(UCHAR)s[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    return h;
+}
+
+/* the slot of the hash table (of mask + 1 slots) for hash h that either
+   holds string s of n characters or is empty */
+static size_t F_(sdfind_)(const SDICT_ *d, const unsigned *table, size_t mask,
+                          unsigned long h, const CHAR *s, size_t n) {
+    size_t i, k;
+    unsigned e;
+    for (i = (size_t)h & mask; (e = table[i]) != 0; i = (i + 1) & mask) {
+        const CHAR *t = d->text + d->offs[e - 1];
+        if (d->offs[e] - d->offs[e - 1] - 1 != n)
+            continue;
+        for (k = 0; k < n && t[k] == s[k]; ++k)
+            ;
+        if (k == n)
+            break;
+    }
+    return i;
+}
+
+/* find the ID of string s of n characters in a dictionary, adding it if it
+   is not there yet. s may be the unused memory after the strings, as long as
+   there is room for a terminator after it
+
+   return value: 0 if OK, -1 if out of memory or IDs
+*/
+static int F_(sdintern_)(SDICT_ *d, const CHAR *s, size_t n, unsigned *id) {
+    unsigned long h = F_(sdhash_)(s, n);
+    size_t i, slots = d->tablecap / sizeof(unsigned), k;
+    void *p;
+
+    if (slots) {
+        i = F_(sdfind_)(d, d->table, slots - 1, h, s, n);
+        if (d->table[i]) {
+            *id = d->table[i] - 1;
+            return 0;
+        }
+    }
+
+    /* a new string, which is kept at most half full */
+    if (!d->resize || d->count >= UINT_MAX - 1
+            || (size_t)d->count + 2 > SIZE_MAX / sizeof(size_t)
+            || n > (SIZE_MAX - 1) / sizeof(CHAR) - d->textlen)
+        return -1;
+    if (!(p = sdgrow_(d->resize, d->data, d->text, &d->textcap,
+                      (d->textlen + n + 1) * sizeof(CHAR))))
+        return -1;
+    d->text = (CHAR *)p;
+    if (!(p = sdgrow_(d->resize, d->data, d->offs, &d->offscap,
+                      ((size_t)d->count + 2) * sizeof(size_t))))
+        return -1;
+    d->offs = (size_t *)p;
+    if (((size_t)d->count + 1) * 2 > slots) {
+        /* rehash into a table twice as large */
+        size_t nslots = slots ? slots * 2 : 16, nsize;
+        unsigned *table;
+        unsigned e;
+        if (nslots > SIZE_MAX / sizeof(unsigned))
+            return -1;
+        nsize = nslots * sizeof(unsigned);
+        if (!(table = (unsigned *)d->resize(d->data, NULL, 0, nsize)))
+            return -1;
+        for (k = 0; k < nslots; ++k)
+            table[k] = 0;
+        for (e = 0; e < d->count; ++e) {
+            const CHAR *t = d->text + d->offs[e];
+            size_t tn = d->offs[e + 1] - d->offs[e] - 1;
+            table[F_(sdfind_)(d, table, nslots - 1, F_(sdhash_)(t, tn),
+                              t, tn)] = e + 1;
+        }
+        if (d->table)
+            d->resize(d->data, d->table, d->tablecap, 0);
+        d->table = table, d->tablecap = nsize, slots = nslots;
+    }
+
+    if (!d->count)
+        d->offs[0] = 0;
+    for (k = 0; k < n; ++k)
+        d->text[d->textlen + k] = s[k];
+    d->textlen += n;
+    d->text[d->textlen++] = 0;
+    d->offs[d->count + 1] = d->textlen;
+    i = F_(sdfind_)(d, d->table, slots - 1, h, s, n);
+    d->table[i] = ++d->count;
+    *id = d->count - 1;
+    return 0;
+}
+
+/* the string with an ID in a dictionary, NULL if there is no such ID */
+static const CHAR *F_(sdget_)(const SDICT_ *d, unsigned id, size_t *n) {
+    if (id >= d->count)
+        return NULL;
+    if (n)
+        *n = d->offs[id + 1] - d->offs[id] - 1;
+    return d->text + d->offs[id];
+}
+
+/* add the strings of dictionary from to d, storing the ID each of them has
+   in d into map (unless it is NULL) at the ID it has in from
+
+   return value: 0 if OK, -1 if out of memory or IDs
+*/
+static int F_(sdmerge_)(SDICT_ *d, const SDICT_ *from, unsigned *map) {
+    unsigned e, id;
+    for (e = 0; e < from->count; ++e) {
+        size_t n;
+        const CHAR *s = F_(sdget_)(from, e, &n);
+        if (F_(sdintern_)(d, s, n, &id))
+            return -1;
+        if (map)
+            map[e] = id;
+    }
+    return 0;
+}
+
+/* read string from stream and intern it into a dictionary, for %y
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    ctype: A_STRING or A_SCANSET
+    set: a struct scanset_, only used with A_SCANSET
+    d: the dictionary, NULL if nostore
+    id: where the ID of the string is stored
+
+    return value: 1 if conversion OK, 0 if not
+*/
+static NOINLINE BOOL F_(iscany_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, enum iscans_type ctype,
+                    const STRUCT_SCANSET *set, SDICT_ *d, unsigned *id) {
+    CINT next = *nextc;
+    size_t nowread = *readin, from = nowread;
+    BOOL ok;
+
+    if (!d || in->kind == SI_STRING || in->kind == SI_BUFFER) {
+        /* input that is all in memory is looked up where it is, and only
+           copied if it is new */
+        const CHAR *s = (const CHAR *)in->ptr;
+        ok = F_(iscans_)(in, &next, &nowread, maxlen, ctype, set, 1, NULL);
+        if (ok && d && F_(sdintern_)(d, s, nowread - from, id))
+            ok = 0;
+    } else {
+        /* anything else is read after the strings, as if it were new, a
+           piece at a time like with %m */
+        void *p;
+        size_t lim;
+        ok = 1;
+        do {
+            size_t room, used = d->textlen + (nowread - from);
+            if (!d->resize || used > SIZE_MAX / sizeof(CHAR) - SALLOC_FIRST
+                    || !(p = sdgrow_(d->resize, d->data, d->text,
+                                     &d->textcap,
+                                     (used + SALLOC_FIRST) * sizeof(CHAR)))) {
+                ok = 0;
+                break;
+            }
+            d->text = (CHAR *)p;
+            room = d->textcap / sizeof(CHAR) - 1 - used;
+            lim = maxlen - nowread > room ? nowread + room : maxlen;
+            ok = F_(iscans_)(in, &next, &nowread, lim, ctype, set, 0,
+                             d->text + used);
+        } while (ok && nowread == lim && lim != maxlen);
+        if (ok && F_(sdintern_)(d, d->text + d->textlen, nowread - from, id))
+            ok = 0;
+    }
+
+    *nextc = next;
+    *readin = nowread;
+    return ok;
+}
+#endif /* SCANF_USE_INTERN */
+
+#if SCANF_KEYWORDS
+#ifndef SCANF_REPEAT
+/* most keywords in one %{...}e, and most characters in its list */
+#define SKEY_MAX 16
+#define SKEY_TEXT 255
+
+/* the keywords of %{...}e in sorted order, found when the format is
+   decoded. the keywords that start with what has been read of a field are
+   then always a run of them, which is narrowed down with every character,
+   and the field ends as soon as no keyword goes on with the next one */
+struct skeys_ {
+    /* number of keywords */
+    unsigned char count;
+    /* index of each keyword, in sorted order */
+    unsigned char order[SKEY_MAX];
+    /* where each keyword begins in the list, and one past the end */
+    unsigned char off[SKEY_MAX + 1];
+};
+
+/* length of keyword i */
+#define SKEY_LEN(k, i) ((size_t)((k)->off[(i) + 1] - (k)->off[i] - 1))
+#endif /* SCANF_REPEAT */
+
+/* compare keywords i and j of list like strcmp does, so that one that
+   begins the other comes first */
+static int F_(ikeycmp_)(const struct skeys_ *k, const UCHAR *list,
+                        size_t i, size_t j) {
+    const UCHAR *a = list + k->off[i], *b = list + k->off[j];
+    size_t m = SKEY_LEN(k, i), n = SKEY_LEN(k, j), p;
+    for (p = 0; p < m && p < n; ++p)
+        if (a[p] != b[p])
+            return a[p] < b[p] ? -1 : 1;
+    return m < n ? -1 : m > n;
+}
+
+/* set up k for the keywords in list, separated by |
+
+   return value: 1 if OK, 0 if a keyword is empty or repeated or there are
+                 too many of them
+*/
+static NOINLINE BOOL F_(ikeys_)(struct skeys_ *k, const UCHAR *list,
+                                size_t len) {
+    size_t i, j, n = 0;
+    int c;
+
+    if (len > SKEY_TEXT - 1)
+        return 0;
+    k->off[0] = 0;
+    for (i = 0; i <= len; ++i) {
+        if (i == len || list[i] == C_('|')) {
+            if (i == k->off[n] || n >= SKEY_MAX)
+                return 0;
+            k->off[++n] = (unsigned char)(i + 1);
+        }
+    }
+    k->count = (unsigned char)n;
+
+    /* insertion sort, since there are only a few of them */
+    for (i = 0; i < n; ++i) {
+        for (j = i, c = 1; j; --j) {
+            c = F_(ikeycmp_)(k, list, k->order[j - 1], i);
+            if (c <= 0)
+                break;
+            k->order[j] = k->order[j - 1];
+        }
+        /* two keywords are the same */
+        if (!c)
+            return 0;
+        k->order[j] = (unsigned char)i;
+    }
+    return 1;
+}
+
+/* read one of the keywords of list, for %{...}e. characters are read for
+   as long as some keyword starts with them, and they must then be a whole
+   keyword, so nothing needs to be unread
+    in: input source
+    nextc: pointer to next character in buffer
+    readin: pointer to number of characters read
+    maxlen: value that *readin should be at most
+    k: the keywords, from F_(ikeys_)
+    list: the keywords, separated by |
+    index: where the index of the keyword is stored, NULL if nostore
+
+    return value: 1 if conversion OK, 0 if not
+*/
+static NOINLINE BOOL F_(iscane_)(struct F_(sinput_) *in, CINT *nextc,
+                    size_t *readin, size_t maxlen, const struct skeys_ *k,
+                    const UCHAR *list, int *index) {
+    CINT next = *nextc;
+    size_t nowread = *readin, p = 0;
+    const UCHAR *ptr, *end;
+    /* the run of sorted keywords that start with the p characters read */
+    size_t lo = 0, hi = k->count;
+    unsigned e;
+
+    LOAD_INPUT();
+    while (KEEP_READING()) {
+        UCHAR c = (UCHAR)next;
+        size_t a, b;
+        /* the keyword that is only those p characters comes first in the
+           run, and then the others by their next character */
+        for (a = lo; a < hi; ++a) {
+            e = k->order[a];
+            if (SKEY_LEN(k, e) > p && list[k->off[e] + p] >= c)
+                break;
+        }
+        if (a == hi || list[k->off[k->order[a]] + p] != c)
+            break;
+        for (b = a + 1; b < hi && list[k->off[k->order[b]] + p] == c; ++b)
+            ;
+        lo = a, hi = b, ++p;
+        NEXT_CHAR(nowread);
+    }
+    SAVE_INPUT();
+    *nextc = next;
+    *readin = nowread;
+
+    e = k->order[lo];
+    if (!p || SKEY_LEN(k, e) != p)
+        return 0;
+    if (index)
+        *index = (int)e;
+    return 1;
+}
+#else
+struct skeys_;
+#endif /* SCANF_KEYWORDS */
+
+/* =============================== *
+ *        extension support        *
+ * =============================== */
+
+/* there should almost never be a reason to change this */
+#ifndef SCANF_EXT_CHAR
+#define SCANF_EXT_CHAR '!'
+#endif
+
+#if SCANF_EXTENSIONS
+#if SCANF_WIDE
+int scnwext_(WINT (*getwch)(void *data), void *data, const WCHAR **format,
+             WINT *buffer, int length, int nostore, void *destination);
+#else
+int scnext_(int (*getch)(void *data), void *data, const char **format,
+            int *buffer, int length, int nostore, void *destination);
+#endif
+
+struct F_(scanf_ext_tmp) {
+    struct F_(sinput_) *in;
+    size_t len;
+};
+
+CINT F_(scanf_ext_getch_)(void *data) {
+    struct F_(scanf_ext_tmp) *st = (struct F_(scanf_ext_tmp) *)data;
+    struct F_(sinput_) *in = st->in;
+    if (!st->len)
+        return GCEOF;
+    else {
+        --st->len;
+        return ++in->ptr != in->end && *in->ptr ? (CINT)*in->ptr
+                                                : F_(srefill_)(in);
+    }
+}
+#endif /* SCANF_EXTENSIONS */
+
+/* =============================== *
+ *       main scanf function       *
+ * =============================== */
+
+#ifndef SCANF_REPEAT
+        /* signal input failure and exit loop */
+#define INPUT_FAILURE() do { goto read_failure; } while (0)
+        /* signal match OK */
+#define MATCH_SUCCESS() (noconv = 0)
+        /* signal match failure and exit loop */
+#define MATCH_FAILURE() do { if (!GOT_EOF()) MATCH_SUCCESS(); \
+                             INPUT_FAILURE(); } while (0)
+            /* store value to dst with cast */
+#define STORE_DST(value, T) (*(T *)(dst) = (T)(value))
+        /* call a conversion function reading from in. the cached window
+           position is written back before the call and reloaded after it */
+#define CONVERT(x) (SAVE_INPUT(), convok = (x), LOAD_INPUT(), convok)
+            /* store value to dst with cast and possible signed clamp */
+#if SCANF_CLAMP
+#define STORE_DSTI(v, T, minv, maxv) STORE_DST(clamps_(minv, v, maxv), T)
+#else
+#define STORE_DSTI(v, T, minv, maxv) STORE_DST(v, T)
+#endif
+            /* store value to dst with cast and possible unsigned clamp */
+#if SCANF_CLAMP
+#define STORE_DSTU(v, T, minv, maxv) STORE_DST(clampu_(minv, v, maxv), T)
+#else
+#define STORE_DSTU(v, T, minv, maxv) STORE_DST(v, T)
+#endif
+#endif
+
+#ifndef SCANF_REPEAT
+#define vLNa_(x) LN_##x
+#define vLN_(x) vLNa_(x)
+
+#if PTRDIFF_MAX_COMPUTE
+static const int signed_padding_div_ = (int)(                                  \
+        (sizeof(ptrdiff_t) > sizeof(uintmax_t) ? 1 :                           \
+            INT_MAX < UINTMAX_MAX ?                                            \
+                ((uintmax_t)1 << (CHAR_BIT * sizeof(int)))                     \
+                    / ((uintmax_t)INT_MAX + 1) :                               \
+            SHRT_MAX < UINTMAX_MAX ?                                           \
+                ((uintmax_t)1 << (CHAR_BIT * sizeof(short)))                   \
+                    / ((uintmax_t)SHRT_MAX + 1) : 2));
+static const ptrdiff_t ptrdiff_max_ = (ptrdiff_t)                              \
+        (sizeof(ptrdiff_t) > sizeof(intmax_t) ? 0 :                            \
+            sizeof(ptrdiff_t) == sizeof(intmax_t)                              \
+                ? INTMAX_MAX                                                   \
+                : (((uintmax_t)1 << (CHAR_BIT * sizeof(ptrdiff_t)))            \
+                    / signed_padding_div_ + UINTMAX_MAX));
+#endif
+#if PTRDIFF_MIN_COMPUTE
+static const ptrdiff_t ptrdiff_min_ = (ptrdiff_t)                              \
+        (sizeof(ptrdiff_t) > sizeof(intmax_t) ? 0 :                            \
+            sizeof(ptrdiff_t) == sizeof(intmax_t)                              \
+                ? INTMAX_MIN                                                   \
+                : (~(intmax_t)-1 > ~(intmax_t)-2)                              \
+                    ? -PTRDIFF_MAX : -PTRDIFF_MAX + ~(intmax_t)0);
+#endif
+
+/* the limit given to iaton_ for an integer conversion: values over it are
+   not stored at all or clamped to the same value when stored */
+static uintmax_t ilimit_(BOOL nostore, BOOL isptr, enum dlength dlen,
+                         BOOL unsign) {
+    if (nostore)
+        return 0;
+#if SCANF_CLAMP
+    if (!isptr) {
+        /* anything over the largest magnitude of the type */
+        switch (dlen) {
+        case LN_hh:
+            return unsign ? UCHAR_MAX : (uintmax_t)SCHAR_MAX + 1;
+        case LN_h:
+            return unsign ? USHRT_MAX : (uintmax_t)SHRT_MAX + 1;
+        case LN_:
+            return unsign ? UINT_MAX : (uintmax_t)INT_MAX + 1;
+        case LN_l:
+            return unsign ? ULONG_MAX : (uintmax_t)LONG_MAX + 1;
+        default:
+            break;
+        }
+    }
+#else
+    (void)isptr;
+    (void)dlen;
+    (void)unsign;
+#endif
+    return UINTMAX_MAX;
+}
+
+/* kinds of format directives */
+enum sop_kind {
+    OP_END,         /* end of the format */
+    OP_SPACE,       /* skip any amount of whitespace */
+    OP_LITERAL,     /* match a run of literal characters */
+    OP_CONV,        /* conversion specification */
+    OP_FAIL,        /* conversion specification that is not supported */
+    OP_EXT,         /* extension conversion specification, %! */
+    OP_INTERP       /* compiled only: interpret the rest of the format */
+};
+#endif /* SCANF_REPEAT */
+
+/* a decoded format directive. a compiled format is an array of these,
+   ending in OP_END and followed by the literal runs and scansets they
+   point to */
+struct F_(sdir_) {
+    unsigned char kind;     /* enum sop_kind */
+    /* OP_CONV: length (enum dlength), whether * was given and
+                conversion character */
+    unsigned char dlen;
+    BOOL nostore;
+    UCHAR conv;
+    /* OP_CONV: whether ' was given; whether m was given; the escapes to
+                decode (enum idecode_type) */
+    BOOL group, alloc;
+    unsigned char decode;
+    /* OP_CONV, OP_EXT: field width, 0 if none */
+    size_t width;
+    /* OP_CONV: precision, 0 if none; the number of elements for %Hf and
+       %Bf, which store an array, or of digits after the point for %D */
+    size_t prec;
+    /* OP_LITERAL: characters to match, OP_EXT: format after the !,
+       OP_INTERP: rest of the format, OP_CONV with %{...}e: the keywords */
+    const UCHAR *text;
+    size_t textlen;
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+    /* OP_CONV with %[ */
+    struct F_(scanset_) set;
+#endif
+#if SCANF_KEYWORDS
+    /* OP_CONV with %{...}e */
+    const struct skeys_ *keys;
+#endif
+};
+
+/*
+    decode a conversion specification
+    f: the format, pointing past the %
+    dir: the decoded directive
+    mention: storage for the %[ mask, with fast scansets only
+    kstore: storage for the keywords of %{...}e, with SCANF_KEYWORDS only
+
+    return value: the format past the specification
+*/
+static ALWAYS_INLINE const UCHAR *F_(idecodespec_)(const UCHAR *f,
+                                            struct F_(sdir_) *dir,
+                                            unsigned *mention,
+                                            struct skeys_ *kstore) {
+    /* maximum number of characters to be read "field width" */
+    size_t maxlen = 0;
+#if SCANF_USE_FLOAT16 || SCANF_FIXED_POINT
+    /* was there a precision? */
+    BOOL hasprec = 0;
+#endif
+    UCHAR c;
+
+#if SCANF_DISABLE_SUPPORT_SCANSET || !SCANF_CAN_FAST_SCANSET
+    (void)mention;
+#endif
+#if !SCANF_KEYWORDS
+    (void)kstore;
+#endif
+
+    dir->kind = OP_CONV;
+    dir->dlen = LN_;
+
+    /* nostore is %*, prevents a value from being stored */
+    dir->nostore = *f == C_('*');
+    if (dir->nostore)
+        ++f;
+
+    /* group is %', allows digit group separators in decimal numbers */
+    dir->group = 0;
+#if SCANF_GROUPING
+    if (*f == C_('\'')) {
+        dir->group = 1;
+        ++f;
+    }
+#endif
+
+    /* width specifier => maxlen */
+    if (F_(isdigit)(*f)) {
+        size_t pr = 0;
+#if !SCANF_MINIMIZE
+        /* skip initial zeros */
+        while (*f == C_('0'))
+            ++f;
+#endif
+        while (F_(isdigit)(*f)) {
+            maxlen = maxlen * 10 + F_(ctodn_)(*f);
+            if (maxlen < pr) {
+                maxlen = SIZE_MAX;
+                while (F_(isdigit)(*f))
+                    ++f;
+                break;
+            } else
+                pr = maxlen;
+            ++f;
+        }
+    }
+    dir->width = maxlen;
+    dir->prec = 0;
+
+#if SCANF_USE_FLOAT16 || SCANF_FIXED_POINT
+    /* precision specifier => number of elements or digits */
+    if (*f == C_('.')) {
+        size_t pr = 0;
+        hasprec = 1;
+        ++f;
+        while (F_(isdigit)(*f)) {
+            dir->prec = dir->prec * 10 + F_(ctodn_)(*f);
+            if (dir->prec < pr) {
+                dir->prec = SIZE_MAX;
+                while (F_(isdigit)(*f))
+                    ++f;
+                break;
+            } else
+                pr = dir->prec;
+            ++f;
+        }
+    }
+#endif
+
+    /* alloc is %m, allocates the memory a string is stored in */
+    dir->alloc = 0;
+#if SCANF_ALLOC
+    if (*f == C_('m')) {
+        dir->alloc = 1;
+        ++f;
+    }
+#endif
+
+    /* decode is %U or %Q, decodes URL or backslash escapes in a string */
+    dir->decode = E_NONE;
+#if SCANF_DECODE
+    if (*f == C_('U'))
+        dir->decode = E_URL, ++f;
+    else if (*f == C_('Q'))
+        dir->decode = E_C, ++f;
+#endif
+
+#if SCANF_EXTENSIONS
+    if (*f == C_(SCANF_EXT_CHAR)) {
+        /* the extension consumes its own part of the format */
+        dir->kind = OP_EXT;
+        dir->text = ++f;
+        return f;
+    }
+#endif
+
+    /* length specifier */
+    switch (*f++) {
+    case C_('h'):
+        if (*f == C_('h'))
+            dir->dlen = LN_hh, ++f;
+        else
+            dir->dlen = LN_h;
+        break;
+    case C_('l'):
+#if !SCANF_DISABLE_SUPPORT_LONG_LONG
+        if (*f == C_('l'))
+            dir->dlen = LN_ll, ++f;
+        else
+#endif
+            dir->dlen = LN_l;
+        break;
+    case C_('j'):
+#ifdef INTMAXT_ALIAS
+        dir->dlen = vLN_(INTMAXT_ALIAS);
+#else
+        dir->dlen = LN_j;
+#endif
+        break;
+    case C_('t'):
+#if PTRDIFFT_DISABLE
+        dir->kind = OP_FAIL;
+#else
+#ifdef PTRDIFFT_ALIAS
+        dir->dlen = vLN_(PTRDIFFT_ALIAS);
+#else
+        if (sizeof(ptrdiff_t) > sizeof(intmax_t))
+            dir->kind = OP_FAIL;
+        dir->dlen = LN_t;
+#endif
+#endif /* PTRDIFFT_DISABLE */
+        break;
+    case C_('z'):
+#if SIZET_DISABLE
+        dir->kind = OP_FAIL;
+#else
+#ifdef SIZET_ALIAS
+        dir->dlen = vLN_(SIZET_ALIAS);
+#else
+        if (sizeof(size_t) > sizeof(uintmax_t))
+            dir->kind = OP_FAIL;
+        dir->dlen = LN_z;
+#endif
+#endif /* SIZET_DISABLE */
+        break;
+    case C_('L'):
+        dir->dlen = LN_L;
+        break;
+#if SCANF_USE_INT128
+    case C_('w'):
+        /* C23 exact-width lengths, of which only w128 is needed; the rest
+           have their own letters */
+        if (f[0] == C_('1') && f[1] == C_('2') && f[2] == C_('8')
+                && !F_(isdigit)(f[3]))
+            dir->dlen = LN_w128, f += 3;
+        else
+            dir->kind = OP_FAIL;
+        break;
+#endif
+#if SCANF_VIEW
+    case C_('v'):
+        /* %v reads a string and %v[ a scanset, but only as views */
+        dir->dlen = LN_v;
+        if (*f != C_('['))
+            --f;
+        break;
+#endif
+#if SCANF_SINK
+    case C_('k'):
+        /* %k sends what %s would read to a sink, and %k[ and %kc what %[
+           and %c would */
+        dir->dlen = LN_k;
+        if (*f != C_('[') && *f != C_('c'))
+            --f;
+        break;
+#endif
+#if SCANF_KEYWORDS
+    case C_('{'):
+        /* %{a|b|c}e reads one of the keywords a, b and c */
+        dir->dlen = LN_kw;
+        dir->text = f;
+        while (*f && *f != C_('}'))
+            ++f;
+        dir->textlen = (size_t)(f - dir->text);
+        dir->keys = kstore;
+        if (!*f || !F_(ikeys_)(kstore, dir->text, dir->textlen))
+            dir->kind = OP_FAIL;
+        else
+            ++f;
+        break;
+#endif
+#if SCANF_USE_INTERN
+    case C_('y'):
+        /* %y interns what %s would read into a dictionary, and %y[ what %[
+           would */
+        dir->dlen = LN_y;
+        if (*f != C_('['))
+            --f;
+        break;
+#endif
+#if SCANF_USE_FLOAT16
+    case C_('H'):
+        dir->dlen = LN_H;
+        break;
+    case C_('B'):
+        dir->dlen = LN_B;
+        break;
 #endif
-        NEXT_CHAR(nowread);
+    default:
+        --f;
     }
 
-    *nextc = next;
-    *readin = nowread;
-    switch (ctype) {
-    case A_CHAR:
-        if (nowread < maxlen)
-            return 0;
-        break;
-    case A_STRING:
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-    case A_SCANSET:
+    dir->conv = c = *f;
+#if SCANF_USE_FLOAT16
+    /* H and B only go with floats */
+    if (dir->dlen == LN_H || dir->dlen == LN_B) {
+        switch (c) {
+        case C_('e'): case C_('E'):
+        case C_('f'): case C_('F'):
+        case C_('g'): case C_('G'):
+        case C_('a'): case C_('A'):
+            break;
+        default:
+            dir->kind = OP_FAIL;
+        }
+    }
 #endif
-        if (!nowread)
-            return 0;
-        if (!nostore)
-            *outp = 0;
-#if SCANF_DISABLE_SUPPORT_SCANSET
-    default: ; /* inhibit compiler warning for missing case for enum */
+#if SCANF_USE_FLOAT16 || SCANF_FIXED_POINT
+    /* only arrays of H and B and the digits of D take a precision */
+    if (hasprec) {
+        switch (dir->dlen) {
+#if SCANF_USE_FLOAT16
+        case LN_H:
+        case LN_B:
+            /* an explicit zero would read nothing */
+            if (!dir->prec)
+                dir->kind = OP_FAIL;
+            break;
 #endif
+        default:
+#if SCANF_FIXED_POINT
+            if (c != C_('D'))
+#endif
+                dir->kind = OP_FAIL;
+        }
     }
-    return 1;
-}
 #endif
-
-/* =============================== *
- *        extension support        *
- * =============================== */
-
-/* there should almost never be a reason to change this */
-#ifndef SCANF_EXT_CHAR
-#define SCANF_EXT_CHAR '!'
+#if SCANF_GROUPING
+    /* and ' only goes with decimal numbers */
+    if (dir->group) {
+        switch (c) {
+        case C_('d'): case C_('i'): case C_('u'):
+#if SCANF_FIXED_POINT
+        case C_('D'):
+#endif
+        case C_('e'): case C_('E'):
+        case C_('f'): case C_('F'):
+        case C_('g'): case C_('G'):
+        case C_('a'): case C_('A'):
+            break;
+        default:
+            dir->kind = OP_FAIL;
+        }
+    }
 #endif
-
-#if SCANF_EXTENSIONS
+#if SCANF_ALLOC
+    /* and m with strings */
+    if (dir->alloc && ((c != C_('c') && c != C_('s') && c != C_('['))
+                       || dir->dlen == LN_v || dir->dlen == LN_k
+                       || dir->dlen == LN_y))
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_DECODE
+    /* and U and Q with strings stored as they are read */
+    if (dir->decode && ((c != C_('s') && c != C_('['))
 #if SCANF_WIDE
-int scnwext_(WINT (*getwch)(void *data), void *data, const WCHAR **format,
-             WINT *buffer, int length, int nostore, void *destination);
+                        || dir->dlen != LN_l
 #else
-int scnext_(int (*getch)(void *data), void *data, const char **format,
-            int *buffer, int length, int nostore, void *destination);
+                        || dir->dlen != LN_
+#endif
+                        || dir->alloc))
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_VIEW
+    /* and v with no other length */
+    if (c == C_('v') && dir->dlen != LN_v)
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_SINK
+    /* and k */
+    if (c == C_('k') && dir->dlen != LN_k)
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_KEYWORDS
+    /* and keywords with e, without ' */
+    if (dir->dlen == LN_kw && (c != C_('e') || dir->group))
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_USE_INTERN
+    /* and y */
+    if (c == C_('y') && dir->dlen != LN_y)
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_FIXED_POINT
+    /* D stores integers, so L makes no sense */
+    if (c == C_('D') && dir->dlen == LN_L)
+        dir->kind = OP_FAIL;
+#endif
+#if SCANF_USE_INT128
+    /* and w128 with integers, but not %n or %p */
+    if (dir->dlen == LN_w128) {
+        switch (c) {
+        case C_('d'): case C_('i'): case C_('u'):
+        case C_('o'): case C_('x'): case C_('X'):
+#if SCANF_BINARY
+        case C_('b'):
+#endif
+            break;
+        default:
+            dir->kind = OP_FAIL;
+        }
+    }
+#endif
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+    if (c == C_('[')) {
+        const UCHAR *set;
+#if SCANF_CAN_FAST_SCANSET
+        BOOL hyphen = 0;
+        UCHAR prev = 0;
+        size_t k;
+        for (k = 0; k < SSET_WORDS; ++k)
+            mention[k] = 0;
+#endif
+        ++f;
+        dir->set.invert = *f == C_('^');
+        if (dir->set.invert)
+            ++f;
+        /* a ] right at the start is part of the set */
+        set = f;
+        if (*f == C_(']'))
+            ++f;
+        while (*f && *f != C_(']'))
+            ++f;
+#if SCANF_CAN_FAST_SCANSET
+        /* set the bits of the listed characters */
+        for (k = 0; set + k < f; ++k) {
+            c = set[k];
+            if (hyphen) {
+                F_(isetrange_)(mention, prev, c);
+                hyphen = 0;
+                prev = c;
+            } else if (c == C_('-') && prev)
+                hyphen = 1;
+            else
+                F_(isetrange_)(mention, c, c), prev = c;
+        }
+        if (hyphen)
+            F_(isetrange_)(mention, C_('-'), C_('-'));
+        dir->set.mask = mention;
+#endif /* SCANF_CAN_FAST_SCANSET */
+#if !SCANF_CAN_FAST_SCANSET || SCANF_SCANSET_HIGH
+        dir->set.set_begin = set, dir->set.set_end = f;
 #endif
+    }
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+    if (*f)
+        ++f; /* next fmt char */
+    return f;
+}
 
-struct F_(scanf_ext_tmp) {
-    CINT (*getch)(void *data);
-    void *data;
-    size_t len;
-};
+/*
+    decode a format directive
+    f: the format, pointing to the directive
+    dir: the decoded directive
+    mention: storage for the %[ mask, with fast scansets only
+    kstore: storage for the keywords of %{...}e, with SCANF_KEYWORDS only
 
-CINT F_(scanf_ext_getch_)(void *data) {
-    struct F_(scanf_ext_tmp) *st = (struct F_(scanf_ext_tmp) *)data;
-    if (!st->len)
-        return GCEOF;
-    else {
-        --st->len;
-        return st->getch(st->data);
+    return value: the format past the directive, NULL at the end
+*/
+static const UCHAR *F_(idecode_)(const UCHAR *f, struct F_(sdir_) *dir,
+                                 unsigned *mention, struct skeys_ *kstore) {
+    UCHAR c = *f++;
+
+    if (!c)
+        return NULL;
+    if (F_(isspace)(c)) {
+        while (F_(isspace)(*f))
+            ++f;
+        dir->kind = OP_SPACE;
+    } else if (c != C_('%')) {
+        dir->kind = OP_LITERAL;
+        dir->text = f - 1;
+        while (*f && *f != C_('%') && !F_(isspace)(*f))
+            ++f;
+        dir->textlen = (size_t)(f - dir->text);
+    } else
+        f = F_(idecodespec_)(f, dir, mention, kstore);
+    return f;
+}
+
+#ifndef SCANF_REPEAT
+/*
+    reserve data in a program being compiled
+    data: start of the data of the program, NULL when only measuring
+    off: offset of the free space in data, updated past the reserved space
+    src: the bytes to copy
+    len: number of bytes to copy
+    align: required alignment of the copy
+
+    return value: the copy, NULL when only measuring
+*/
+static void *icdata_(unsigned char *data, size_t *off, const void *src,
+                     size_t len, size_t align) {
+    const unsigned char *s = (const unsigned char *)src;
+    unsigned char *d;
+    size_t i;
+    *off = (*off + align - 1) / align * align;
+    if (!data) {
+        *off += len;
+        return NULL;
     }
+    d = data + *off;
+    for (i = 0; i < len; ++i)
+        d[i] = s[i];
+    *off += len;
+    return d;
 }
-#endif /* SCANF_EXTENSIONS */
+#endif /* SCANF_REPEAT */
 
-/* =============================== *
- *       main scanf function       *
- * =============================== */
+/*
+    compile a format
+    buf: where to store the program, aligned for any object
+    size: size of buf in bytes
+    format: the format string
 
-#ifndef SCANF_REPEAT
-        /* signal input failure and exit loop */
-#define INPUT_FAILURE() do { goto read_failure; } while (0)
-        /* signal match OK */
-#define MATCH_SUCCESS() (noconv = 0)
-        /* signal match failure and exit loop */
-#define MATCH_FAILURE() do { if (!GOT_EOF()) MATCH_SUCCESS(); \
-                             INPUT_FAILURE(); } while (0)
-            /* store value to dst with cast */
-#define STORE_DST(value, T) (*(T *)(dst) = (T)(value))
-            /* store value to dst with cast and possible signed clamp */
-#if SCANF_CLAMP
-#define STORE_DSTI(v, T, minv, maxv) STORE_DST(clamps_(minv, v, maxv), T)
+    return value: size of the program in bytes. if it is larger than size,
+                  nothing was stored
+*/
+static size_t F_(icompile_)(void *buf, size_t size, const CHAR *format) {
+    struct F_(sdir_) *op = NULL, dir;
+#if !SCANF_DISABLE_SUPPORT_SCANSET && SCANF_CAN_FAST_SCANSET
+    unsigned mention[SSET_WORDS];
 #else
-#define STORE_DSTI(v, T, minv, maxv) STORE_DST(v, T)
+    unsigned *mention = NULL;
 #endif
-            /* store value to dst with cast and possible unsigned clamp */
-#if SCANF_CLAMP
-#define STORE_DSTU(v, T, minv, maxv) STORE_DST(clampu_(minv, v, maxv), T)
+#if SCANF_KEYWORDS
+    struct skeys_ kstore[1];
 #else
-#define STORE_DSTU(v, T, minv, maxv) STORE_DST(v, T)
+    struct skeys_ *kstore = NULL;
+#endif
+#if !SCANF_DISABLE_SUPPORT_SCANSET \
+    && (!SCANF_CAN_FAST_SCANSET || SCANF_SCANSET_HIGH)
+    size_t count;
+#endif
+    const UCHAR *f, *start;
+    unsigned char *data = NULL;
+    size_t nops, off = 0;
+    BOOL more;
+    int pass;
+
+    /* the first pass measures the program, the second one stores it */
+    for (pass = 0; pass < 2; ++pass) {
+        f = (const UCHAR *)format;
+        nops = 0;
+        off = 0;
+        do {
+            start = f;
+            dir.dlen = LN_, dir.nostore = 0, dir.conv = 0, dir.width = 0;
+            dir.prec = 0, dir.group = 0, dir.alloc = 0, dir.decode = E_NONE;
+            dir.text = NULL, dir.textlen = 0;
+            f = F_(idecode_)(start, &dir, mention, kstore);
+            more = f != NULL;
+            if (!more)
+                dir.kind = OP_END;
+            switch (dir.kind) {
+            case OP_LITERAL:
+                dir.text = (const UCHAR *)icdata_(data, &off, dir.text,
+                                dir.textlen * sizeof(UCHAR), sizeof(UCHAR));
+                break;
+#if !SCANF_DISABLE_SUPPORT_SCANSET || SCANF_KEYWORDS
+            case OP_CONV:
+#if SCANF_KEYWORDS
+                if (dir.dlen == LN_kw) {
+                    dir.text = (const UCHAR *)icdata_(data, &off, dir.text,
+                                dir.textlen * sizeof(UCHAR), sizeof(UCHAR));
+                    dir.keys = (const struct skeys_ *)icdata_(data, &off,
+                                kstore, sizeof(*kstore), sizeof(unsigned long));
+                    break;
+                }
+#endif
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+                if (dir.conv != C_('['))
+                    break;
+#if SCANF_CAN_FAST_SCANSET
+                dir.set.mask = (const unsigned *)icdata_(data, &off, mention,
+                                sizeof(mention), sizeof(unsigned));
+#endif
+#if !SCANF_CAN_FAST_SCANSET || SCANF_SCANSET_HIGH
+                count = (size_t)(dir.set.set_end - dir.set.set_begin);
+                dir.set.set_begin = (const UCHAR *)icdata_(data, &off,
+                                dir.set.set_begin, count * sizeof(UCHAR),
+                                sizeof(UCHAR));
+                dir.set.set_end = dir.set.set_begin + count;
 #endif
+#endif /* !SCANF_DISABLE_SUPPORT_SCANSET */
+                break;
 #endif
+            case OP_EXT:
+                /* extensions parse the format themselves, so interpret
+                   the rest of the format starting from this directive */
+                dir.kind = OP_INTERP;
+                while (*f++)
+                    ;
+                dir.text = (const UCHAR *)icdata_(data, &off, start,
+                                (size_t)(f - start) * sizeof(UCHAR),
+                                sizeof(UCHAR));
+                more = 0;
+                break;
+            default:
+                break;
+            }
+            if (pass)
+                *op++ = dir;
+            ++nops;
+        } while (more);
+
+        if (!pass) {
+            if (nops * sizeof(dir) + off > size)
+                return nops * sizeof(dir) + off;
+            op = (struct F_(sdir_) *)buf;
+            data = (unsigned char *)(op + nops);
+        }
+    }
+    return nops * sizeof(dir) + off;
+}
 
-#ifndef SCANF_REPEAT
-/* enum for possible data types */
-enum dlength { LN_, LN_hh, LN_h, LN_l, LN_ll, LN_L, LN_j, LN_z, LN_t };
+#if SCANF_FORMAT_CACHE
+
+/* a cached format and its program */
+struct F_(scache_) {
+    /* the format pointer this entry is for, NULL if the entry is empty */
+    const CHAR *format;
+    /* number of scans running the program, only ever on this thread */
+    unsigned busy;
+    /* a copy of the format, to verify the string has not changed */
+    CHAR text[SCANF_FORMAT_CACHE_LENGTH];
+    union {
+        struct F_(sdir_) op;
+        unsigned char data[SCANF_FORMAT_CACHE_BYTES];
+    } prog;
+};
 
-#define vLNa_(x) LN_##x
-#define vLN_(x) vLNa_(x)
+/* each thread has its own cache, so it needs no locks or atomics and
+   the scanf functions still never wait on each other */
+static SCANF_THREAD_LOCAL struct {
+    struct F_(scache_) entry[SCANF_FORMAT_CACHE];
+    unsigned long hits, misses;
+} F_(cache_);
 
-#if PTRDIFF_MAX_COMPUTE
-static const int signed_padding_div_ = (int)(                                  \
-        (sizeof(ptrdiff_t) > sizeof(uintmax_t) ? 1 :                           \
-            INT_MAX < UINTMAX_MAX ?                                            \
-                ((uintmax_t)1 << (CHAR_BIT * sizeof(int)))                     \
-                    / ((uintmax_t)INT_MAX + 1) :                               \
-            SHRT_MAX < UINTMAX_MAX ?                                           \
-                ((uintmax_t)1 << (CHAR_BIT * sizeof(short)))                   \
-                    / ((uintmax_t)SHRT_MAX + 1) : 2));
-static const ptrdiff_t ptrdiff_max_ = (ptrdiff_t)                              \
-        (sizeof(ptrdiff_t) > sizeof(intmax_t) ? 0 :                            \
-            sizeof(ptrdiff_t) == sizeof(intmax_t)                              \
-                ? INTMAX_MAX                                                   \
-                : (((uintmax_t)1 << (CHAR_BIT * sizeof(ptrdiff_t)))            \
-                    / signed_padding_div_ + UINTMAX_MAX));
-#endif
-#if PTRDIFF_MIN_COMPUTE
-static const ptrdiff_t ptrdiff_min_ = (ptrdiff_t)                              \
-        (sizeof(ptrdiff_t) > sizeof(intmax_t) ? 0 :                            \
-            sizeof(ptrdiff_t) == sizeof(intmax_t)                              \
-                ? INTMAX_MIN                                                   \
-                : (~(intmax_t)-1 > ~(intmax_t)-2)                              \
-                    ? -PTRDIFF_MAX : -PTRDIFF_MAX + ~(intmax_t)0);
-#endif
-#endif /* SCANF_REPEAT */
+/*
+    find the cache entry for a format, compiling the format into it on a miss
+    format: the format string, not empty
+
+    return value: the entry, or NULL if the format could not be cached
+*/
+static NOINLINE struct F_(scache_) *F_(icache_)(const CHAR *format) {
+    uintmax_t h = PTR_TO_INT(format);
+    struct F_(scache_) *e =
+        &F_(cache_).entry[(size_t)((h ^ (h >> 9)) % SCANF_FORMAT_CACHE)];
+    size_t i;
+
+    if (e->format == format) {
+        for (i = 0; e->text[i] == format[i]; ++i) {
+            if (!format[i]) {
+                ++F_(cache_).hits;
+                return e;
+            }
+        }
+    }
+    ++F_(cache_).misses;
+    /* a scan further up the stack (through a callback) is running the
+       program in this entry, so it cannot be replaced */
+    if (e->busy)
+        return NULL;
+    e->format = NULL;
+    for (i = 0; format[i]; ++i)
+        if (i + 1 >= SCANF_FORMAT_CACHE_LENGTH)
+            return NULL;
+    if (F_(icompile_)(&e->prog, sizeof(e->prog), format) > sizeof(e->prog))
+        return NULL;
+    for (i = 0; (e->text[i] = format[i]); ++i)
+        ;
+    e->format = format;
+    return e;
+}
 
-static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
-                       void *p, const CHAR *ff, va_list va) {
+#endif /* SCANF_FORMAT_CACHE */
+
+/* run a format on the input source in, either from the format string ff or,
+   if prog is not NULL, from a compiled format */
+static int F_(iscanf_)(struct F_(sinput_) *in, const CHAR *ff,
+                       const struct F_(sdir_) *prog, va_list va) {
     /* fields = number of fields successfully read; this is the return value */
     int fields = 0;
     /* next = the "next" character to be processed */
@@ -1249,166 +5282,144 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
     size_t read_chars = 0;
     /* there were attempts to convert? there were no conversions? */
     BOOL tryconv = 0, noconv = 1;
+    /* result of the last CONVERT */
+    BOOL convok;
     const UCHAR *f = (const UCHAR *)ff;
+    /* the current directive, and storage for decoding one from f */
+    const struct F_(sdir_) *d;
+    struct F_(sdir_) dir;
+#if !SCANF_DISABLE_SUPPORT_SCANSET && SCANF_CAN_FAST_SCANSET
+    unsigned mention[SSET_WORDS];
+#else
+    unsigned *mention = NULL;
+#endif
+#if SCANF_KEYWORDS
+    struct skeys_ kstore[1];
+#else
+    struct skeys_ *kstore = NULL;
+#endif
     UCHAR c;
+    /* cached window position of in */
+    const UCHAR *ptr, *end;
+#if SCANF_FORMAT_CACHE
+    /* the cache entry prog comes from, if any */
+    struct F_(scache_) *cached = NULL;
+#endif
 
     /* empty format string always returns 0 */
-    if (!*f) return 0;
+    if (prog ? prog->kind == OP_END : !*f) return 0;
+#if SCANF_FORMAT_CACHE
+    if (!prog && (cached = F_(icache_)(ff)) != NULL) {
+        ++cached->busy;
+        prog = &cached->prog.op;
+    }
+#endif
 
     /* read and cache first character */
-    next = getch(p);
+    next = in->ptr != in->end && *in->ptr ? (CINT)*in->ptr : F_(srefill_)(in);
+    LOAD_INPUT();
     /* ++read_chars; intentionally left out, otherwise %n is off by 1 */
-    while ((c = *f++)) {
-        if (F_(isspace)(c)) {
-            /* skip 0-N whitespace */
-            while (!GOT_EOF() && F_(isspace)(next))
-                NEXT_CHAR(read_chars);
-        } else if (c != C_('%')) {
-            if (GOT_EOF()) break;
-            /* must match literal character */
-            if (next != c) {
-                INPUT_FAILURE();
-                break;
-            }
-            NEXT_CHAR(read_chars);
-        } else { /* % */
-            /* nostore is %*, prevents a value from being stored */
-            BOOL nostore;
-            /* nowread = characters read for this format specifier
-               maxlen = maximum number of characters to be read "field width" */
-            size_t nowread = 0, maxlen = 0;
-            /* length specifier (l, ll, h, hh...) */
-            enum dlength dlen = LN_;
-            /* where the value will be stored */
-            void *dst;
-
-            /* nostore */
-            if (*f == C_('*')) {
-                nostore = 1;
-                dst = NULL;
+    while (1) {
+        if (prog) {
+            d = prog++;
+            if (d->kind == OP_END)
+                goto done;
+        } else {
+            /* whitespace and literals are simple enough to not decode */
+            while ((c = *f) != C_('%')) {
+                if (!c)
+                    goto done;
                 ++f;
-            } else {
-                nostore = 0;
-                dst = va_arg(va, void *);
-                /* A pointer to any incomplete or object type may be converted
-                   to a pointer to void and back again; the result shall compare
-                   equal to the original pointer. */
-            }
-
-            /* width specifier => maxlen */
-            if (F_(isdigit)(*f)) {
-                size_t pr = 0;
-#if !SCANF_MINIMIZE
-                /* skip initial zeros */
-                while (*f == C_('0'))
-                    ++f;
-#endif
-                while (F_(isdigit)(*f)) {
-                    maxlen = maxlen * 10 + F_(ctodn_)(*f);
-                    if (maxlen < pr) {
-                        maxlen = SIZE_MAX;
-                        while (F_(isdigit)(*f))
-                            ++f;
-                        break;
-                    } else
-                        pr = maxlen;
-                    ++f;
+                if (F_(isspace)(c)) {
+                    SKIP_SPACE(read_chars);
+                } else {
+                    if (GOT_EOF()) goto done;
+                    /* must match literal character */
+                    if (next != c) INPUT_FAILURE();
+                    NEXT_CHAR(read_chars);
                 }
             }
+            f = F_(idecodespec_)(f + 1, &dir, mention, kstore);
+            d = &dir;
+        }
 
+        switch (d->kind) {
+        case OP_SPACE:
+            SKIP_SPACE(read_chars);
+            break;
+        case OP_LITERAL:
+        {
+            const UCHAR *lit = d->text, *litend = lit + d->textlen;
+            while (lit != litend) {
+                if (GOT_EOF()) INPUT_FAILURE();
+                /* must match literal character */
+                if (next != *lit++) INPUT_FAILURE();
+                NEXT_CHAR(read_chars);
+            }
+            break;
+        }
+        case OP_INTERP:
+            /* continue with the format string */
+            f = d->text;
+            prog = NULL;
+            break;
 #if SCANF_EXTENSIONS
-            if (*f == C_(SCANF_EXT_CHAR)) {
-                const CHAR *sf = (const CHAR *)(f + 1);
-                BOOL hadlen = maxlen != 0;
-                struct F_(scanf_ext_tmp) tmp;
-                int ok;
-
-                if (!hadlen)
-                    maxlen = SIZE_MAX;
-                tmp.getch = getch;
-                tmp.data = p;
-                tmp.len = maxlen;
+        case OP_EXT:
+        {
+            const CHAR *sf = (const CHAR *)d->text;
+            size_t maxlen = d->width;
+            BOOL hadlen = maxlen != 0;
+            void *dst = d->nostore ? NULL : va_arg(va, void *);
+            struct F_(scanf_ext_tmp) tmp;
+            int ok;
+
+            if (!hadlen)
+                maxlen = SIZE_MAX;
+            tmp.in = in;
+            tmp.len = maxlen;
+            SAVE_INPUT();
 #if SCANF_WIDE
-                ok = scnwext_(&F_(scanf_ext_getch_), &tmp, &sf, &next,
-                              hadlen, nostore, dst);
-#else
-                ok = scnext_(&F_(scanf_ext_getch_), &tmp, &sf, &next,
-                             hadlen, nostore, dst);
-#endif
-                f = (const UCHAR *)sf;
-                if (ok < 0)
-                    INPUT_FAILURE();
-                else if (ok > 0)
-                    MATCH_FAILURE();
-                else if (!nostore)
-                    ++fields;
-                read_chars += maxlen - tmp.len;
-                continue;
-            }
-#endif
-
-            /* length specifier */
-            switch (*f++) {
-            case C_('h'):
-                if (*f == C_('h'))
-                    dlen = LN_hh, ++f;
-                else
-                    dlen = LN_h;
-                break;
-            case C_('l'):
-#if !SCANF_DISABLE_SUPPORT_LONG_LONG
-                if (*f == C_('l'))
-                    dlen = LN_ll, ++f;
-                else
-#endif
-                    dlen = LN_l;
-                break;
-            case C_('j'):
-#ifdef INTMAXT_ALIAS
-                dlen = vLN_(INTMAXT_ALIAS);
-#else
-                dlen = LN_j;
-#endif
-                break;
-            case C_('t'):
-#if PTRDIFFT_DISABLE
-                MATCH_FAILURE();
-#else
-#ifdef PTRDIFFT_ALIAS
-                dlen = vLN_(PTRDIFFT_ALIAS);
+            ok = scnwext_(&F_(scanf_ext_getch_), &tmp, &sf, &next,
+                          hadlen, d->nostore, dst);
 #else
-                if (sizeof(ptrdiff_t) > sizeof(intmax_t))
-                    MATCH_FAILURE();
-                dlen = LN_t;
+            ok = scnext_(&F_(scanf_ext_getch_), &tmp, &sf, &next,
+                         hadlen, d->nostore, dst);
 #endif
-                break;
-#endif /* PTRDIFFT_DISABLE */
-            case C_('z'):
-#if SIZET_DISABLE
+            LOAD_INPUT();
+            f = (const UCHAR *)sf;
+            if (ok < 0)
+                INPUT_FAILURE();
+            else if (ok > 0)
                 MATCH_FAILURE();
-#else
-#ifdef SIZET_ALIAS
-                dlen = vLN_(SIZET_ALIAS);
-#else
-                if (sizeof(size_t) > sizeof(uintmax_t))
-                    MATCH_FAILURE();
-                dlen = LN_z;
+            else if (!d->nostore)
+                ++fields;
+            read_chars += maxlen - tmp.len;
+            break;
+        }
 #endif
-                break;
-#endif /* SIZET_DISABLE */
-            case C_('L'):
-                dlen = LN_L;
-                break;
-            default:
-                --f;
-            }
+        case OP_FAIL:
+            MATCH_FAILURE();
+            break;
+        default: /* % */
+        {
+            /* nostore is %*, prevents a value from being stored */
+            BOOL nostore = d->nostore;
+            /* nowread = characters read for this format specifier
+               maxlen = maximum number of characters to be read "field width" */
+            size_t nowread = 0, maxlen = d->width;
+            /* length specifier (l, ll, h, hh...) */
+            enum dlength dlen = (enum dlength)d->dlen;
+            /* where the value will be stored */
+            void *dst = nostore ? NULL : va_arg(va, void *);
+            /* A pointer to any incomplete or object type may be converted
+               to a pointer to void and back again; the result shall compare
+               equal to the original pointer. */
 
-            c = *f;
+            c = d->conv;
             switch (c) {
             default:
                 /* skip whitespace. include in %n, but not elsewhere */
-                while (!GOT_EOF() && F_(isspace)(next))
-                    NEXT_CHAR(read_chars);
+                SKIP_SPACE(read_chars);
                 /* fall-through */
             /* do not skip whitespace for... */
             case C_('['):
@@ -1420,6 +5431,26 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
             case C_('n'):
                 break;
             }
+#if SCANF_VIEW
+            /* %v[ skips no whitespace, but is otherwise read like %v */
+            if (dlen == LN_v)
+                c = C_('v');
+#endif
+#if SCANF_SINK
+            /* and %k[ and %kc like %k */
+            if (dlen == LN_k)
+                c = C_('k');
+#endif
+#if SCANF_USE_INTERN
+            /* and %y[ like %y */
+            if (dlen == LN_y)
+                c = C_('y');
+#endif
+#if SCANF_KEYWORDS
+            /* %{...}e is not a float */
+            if (dlen == LN_kw)
+                c = C_('{');
+#endif
 
             /* format */
             switch (c) {
@@ -1483,6 +5514,26 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
             case C_('b'): /* non-standard: unsigned binary integer */
                     base = 2, unsign = 1;
                     goto readnum;
+#endif
+#if SCANF_FIXED_POINT
+            case C_('D'): /* non-standard: fixed-point decimal */
+                    isptr = 0, unsign = 0, negative = 0;
+                    switch (next) {
+                    case C_('-'):
+                        negative = 1;
+                        /* fall-through */
+                    case C_('+'):
+                        NEXT_CHAR(nowread);
+                    }
+                    if (!maxlen) maxlen = SIZE_MAX;
+                    if (!CONVERT(F_(iatofx_)(in, &next, &nowread, maxlen,
+                                d->prec, negative, d->group, &r.i)))
+                        MATCH_FAILURE();
+                    MATCH_SUCCESS();
+                    if (nostore)
+                        break;
+                    ++fields;
+                    goto storenum;
 #endif
             case C_('u'): /* unsigned decimal integer */
             case C_('d'): /* signed decimal integer */
@@ -1546,9 +5597,22 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                     }
 
                     /* convert */
-                    if (!F_(iaton_)(getch, p, &next, &nowread, maxlen, base,
-                                unsign, negative, zero, unsign ? (void *)&r.u
-                                                               : (void *)&r.i))
+#if SCANF_USE_INT128
+                    if (dlen == LN_w128) {
+                        if (!CONVERT(F_(iaton128_)(in, &next, &nowread,
+                                maxlen, base, unsign, negative, zero,
+                                d->group && base == 10, dst)))
+                            MATCH_FAILURE();
+                        MATCH_SUCCESS();
+                        if (!nostore) ++fields;
+                        break;
+                    }
+#endif
+                    if (!CONVERT(F_(iaton_)(in, &next, &nowread, maxlen, base,
+                                unsign, negative, zero,
+                                d->group && base == 10,
+                                ilimit_(nostore, isptr, dlen, unsign),
+                                unsign ? (void *)&r.u : (void *)&r.i)))
                         MATCH_FAILURE();
 
             readnumok:
@@ -1566,6 +5630,11 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                     STORE_DST(r.p, void *);
                 } else {
                     switch (dlen) {
+#if SCANF_USE_INT128
+                    case LN_w128: /* only the 0 of 0x for %b, etc. */
+                        STORE_DST(r.u, su128_);
+                        break;
+#endif
                     case LN_hh:
                         if (unsign) STORE_DSTU(r.u, unsigned char,
                                                0, UCHAR_MAX);
@@ -1658,11 +5727,26 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                 MATCH_FAILURE();
 #else
             { /* =========== READ FLOAT =========== */
-                floatmax_t r;
+                union sfloat_ r;
                 /* negative? allow zero? hex mode? */
-                BOOL negative = 0, zero = 0, hex = 0;
+                BOOL negative, zero, hex;
+#if SCANF_USE_FLOAT16
+                /* elements left to read into the array at dst */
+                size_t count = d->prec ? d->prec : 1;
+#endif
                 if (!maxlen) maxlen = SIZE_MAX;
+                /* the type the result is stored as */
+#if LDOUBLE_IS_DOUBLE
+                if (dlen == LN_L) dlen = LN_l;
+#endif
+#if DOUBLE_IS_FLOAT
+                if (dlen == LN_l) dlen = LN_;
+#endif
 
+#if SCANF_USE_FLOAT16
+            nextfp:
+#endif
+                negative = 0, zero = 0, hex = 0;
                 switch (next) {
                 case C_('-'):
                     negative = 1;
@@ -1690,7 +5774,7 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                                 MATCH_FAILURE();
                         }
                     }
-                    r = negative ? -NAN : NAN;
+                    fstore_(&r, dlen, negative ? -NAN : NAN);
                     goto storefp;
                 } else if (KEEP_READING() && ICASEEQ(next, 'I', 'i')) {
                     NEXT_CHAR(nowread);
@@ -1712,7 +5796,7 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                             NEXT_CHAR(nowread);
                         }
                     }
-                    r = negative ? -INFINITY : INFINITY;
+                    fstore_(&r, dlen, negative ? -INFINITY : INFINITY);
                     goto storefp;
                 }
 #endif /* SCANF_INFINITE */
@@ -1728,30 +5812,45 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                 }
 
                 /* convert */
-                if (!F_(iatof_)(getch, p, &next, &nowread, maxlen, hex,
-                                negative, zero, &r))
+                if (!CONVERT(F_(iatof_)(in, &next, &nowread, maxlen, hex,
+                                negative, zero, d->group && !hex, dlen, &r)))
                     MATCH_FAILURE();
 
 #if SCANF_INFINITE
             storefp:
 #endif
                 MATCH_SUCCESS();
+#if SCANF_USE_FLOAT16
+                if (dlen == LN_H || dlen == LN_B) {
+                    if (!nostore) {
+                        STORE_DST(r.h, unsigned short);
+                        dst = (unsigned short *)dst + 1;
+                    }
+                    /* the elements are separated by whitespace, and the
+                       array only counts once all of them have been read */
+                    if (--count) {
+                        read_chars += nowread;
+                        nowread = 0;
+                        SKIP_SPACE(read_chars);
+                        if (GOT_EOF()) MATCH_FAILURE();
+                        goto nextfp;
+                    }
+                    if (!nostore) ++fields;
+                    break;
+                }
+#endif
                 if (nostore)
                     break;
                 ++fields;
                 switch (dlen) {
                 case LN_L:
-#if !LDOUBLE_IS_DOUBLE
-                    STORE_DST(r, long double);
+                    STORE_DST(r.l, long double);
                     break;
-#endif
                 case LN_l:
-#if !DOUBLE_IS_FLOAT
-                    STORE_DST(r, double);
+                    STORE_DST(r.d, double);
                     break;
-#endif
                 default:
-                    STORE_DST(r, float);
+                    STORE_DST(r.f, float);
                 }
                 break;
             } /* =========== READ FLOAT =========== */
@@ -1771,27 +5870,27 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
 #endif /* SCANF_WIDE_CONVERT */
                 outp = (CHAR *)dst;
                 if (!maxlen) maxlen = 1;
+#if SCANF_ALLOC
+                if (d->alloc && !nostore) {
+                    if (!CONVERT(F_(iscanm_)(in, &next, &nowread, maxlen,
+                                A_CHAR, NULL, ICVT_(wide), dst)))
+                        MATCH_FAILURE();
+                } else
+#endif
 #if SCANF_WIDE_CONVERT
 #if SCANF_WIDE
                 if (!wide) { /* convert wide => narrow */
 #else /* SCANF_WIDE */
                 if (wide) { /* convert narrow => wide */
 #endif /* SCANF_WIDE */
-                    if (!F_(iscvts_)(getch, p, &next, &nowread, maxlen,
-                                A_CHAR,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                                NULL,
-#endif
-                                nostore, (CVTCHAR *)dst))
+                    if (!CONVERT(F_(iscvts_)(in, &next, &nowread, maxlen,
+                                A_CHAR, NULL, nostore, (CVTCHAR *)dst,
+                                NULL)))
                         MATCH_FAILURE();
                 } else
 #endif /* SCANF_WIDE_CONVERT */
-                if (!F_(iscans_)(getch, p, &next, &nowread, maxlen,
-                                A_CHAR,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                                NULL,
-#endif
-                                nostore, outp))
+                if (!CONVERT(F_(iscans_)(in, &next, &nowread, maxlen,
+                                A_CHAR, NULL, nostore, outp)))
                     MATCH_FAILURE();
                 if (!nostore) ++fields;
                 MATCH_SUCCESS();
@@ -1813,31 +5912,39 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                 outp = (CHAR *)dst;
                 if (!maxlen) {
 #if SCANF_SECURE
-                    if (!nostore) MATCH_FAILURE();
+                    if (!nostore && !d->alloc) MATCH_FAILURE();
 #endif
                     maxlen = SIZE_MAX;
                 }
+#if SCANF_ALLOC
+                if (d->alloc && !nostore) {
+                    if (!CONVERT(F_(iscanm_)(in, &next, &nowread, maxlen,
+                                A_STRING, NULL, ICVT_(wide), dst)))
+                        MATCH_FAILURE();
+                } else
+#endif
 #if SCANF_WIDE_CONVERT
 #if SCANF_WIDE
                 if (!wide) { /* convert wide => narrow */
 #else /* SCANF_WIDE */
                 if (wide) { /* convert narrow => wide */
 #endif /* SCANF_WIDE */
-                    if (!F_(iscvts_)(getch, p, &next, &nowread, maxlen,
-                                A_STRING,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                                NULL,
-#endif
-                                nostore, (CVTCHAR *)dst))
+                    if (!CONVERT(F_(iscvts_)(in, &next, &nowread, maxlen,
+                                A_STRING, NULL, nostore, (CVTCHAR *)dst,
+                                NULL)))
                         MATCH_FAILURE();
                 } else
 #endif /* SCANF_WIDE_CONVERT */
-                if (!F_(iscans_)(getch, p, &next, &nowread, maxlen,
-                                A_STRING,
-#if !SCANF_DISABLE_SUPPORT_SCANSET
-                                NULL,
+#if SCANF_DECODE
+                if (d->decode && !nostore) {
+                    if (!CONVERT(F_(iscand_)(in, &next, &nowread, maxlen,
+                                A_STRING, NULL, (enum idecode_type)d->decode,
+                                outp)))
+                        MATCH_FAILURE();
+                } else
 #endif
-                                nostore, outp))
+                if (!CONVERT(F_(iscans_)(in, &next, &nowread, maxlen,
+                                A_STRING, NULL, nostore, outp)))
                     MATCH_FAILURE();
                 if (!nostore) ++fields;
                 MATCH_SUCCESS();
@@ -1850,15 +5957,6 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
 #else
             { /* =========== READ SCANSET =========== */
                 CHAR *outp;
-                BOOL invert = 0;
-#if SCANF_CAN_FAST_SCANSET
-                BOOL hyphen = 0;
-                BOOL mention[UCHAR_MAX + 1] = { 0 };
-                UCHAR prev = 0, c;
-#else
-                const UCHAR *set;
-#endif
-                struct F_(scanset_) scanset;
 #if SCANF_WIDE_CONVERT
                 BOOL wide = dlen == LN_l;
 #elif SCANF_WIDE /* SCANF_WIDE_CONVERT */
@@ -1871,54 +5969,40 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                 outp = (CHAR *)dst;
                 if (!maxlen) {
 #if SCANF_SECURE
-                    if (!nostore) MATCH_FAILURE();
+                    if (!nostore && !d->alloc) MATCH_FAILURE();
 #endif
                     maxlen = SIZE_MAX;
                 }
-                ++f;
-                if (*f == C_('^'))
-                    invert = 1, ++f;
-                if (*f == C_(']'))
-                    ++f;
-#if SCANF_CAN_FAST_SCANSET
-                /* populate mention, 0 if character not listed, 1 if it is */
-                while ((c = *f) && c != C_(']')) {
-                    if (hyphen) {
-                        int k;
-                        for (k = prev; k <= c; ++k)
-                            mention[k] = 1;
-                        hyphen = 0;
-                        prev = c;
-                    } else if (c == C_('-') && prev)
-                        hyphen = 1;
-                    else
-                        mention[c] = 1, prev = c;
-                    ++f;
-                }
-                if (hyphen)
-                    mention[C_('-')] = 1;
-                scanset.mask = mention;
-#else /* SCANF_CAN_FAST_SCANSET */
-                set = f;
-                while (*f && *f != C_(']'))
-                    ++f;
-                scanset.set_begin = set, scanset.set_end = f;
-#endif /* SCANF_CAN_FAST_SCANSET */
-                scanset.invert = invert;
+#if SCANF_ALLOC
+                if (d->alloc && !nostore) {
+                    if (!CONVERT(F_(iscanm_)(in, &next, &nowread, maxlen,
+                            A_SCANSET, &d->set, ICVT_(wide), dst)))
+                        MATCH_FAILURE();
+                } else
+#endif
 #if SCANF_WIDE_CONVERT
 #if SCANF_WIDE
                 if (!wide) { /* convert wide => narrow */
 #else /* SCANF_WIDE */
                 if (wide) { /* convert narrow => wide */
 #endif /* SCANF_WIDE */
-                    if (!F_(iscvts_)(getch, p, &next, &nowread, maxlen,
-                            A_SCANSET, &scanset, nostore, (CVTCHAR *)dst))
+                    if (!CONVERT(F_(iscvts_)(in, &next, &nowread, maxlen,
+                            A_SCANSET, &d->set, nostore, (CVTCHAR *)dst,
+                            NULL)))
                         MATCH_FAILURE();
                 } else
 #endif /* SCANF_WIDE_CONVERT */
+#if SCANF_DECODE
+                if (d->decode && !nostore) {
+                    if (!CONVERT(F_(iscand_)(in, &next, &nowread, maxlen,
+                            A_SCANSET, &d->set, (enum idecode_type)d->decode,
+                            outp)))
+                        MATCH_FAILURE();
+                } else
+#endif
                 {
-                    if (!F_(iscans_)(getch, p, &next, &nowread, maxlen,
-                            A_SCANSET, &scanset, nostore, outp))
+                    if (!CONVERT(F_(iscans_)(in, &next, &nowread, maxlen,
+                            A_SCANSET, &d->set, nostore, outp)))
                         MATCH_FAILURE();
                 }
                 if (!nostore) ++fields;
@@ -1926,19 +6010,112 @@ static int F_(iscanf_)(CINT (*getch)(void *p), void (*ungetch)(CINT c, void *p),
                 break;
             } /* =========== READ SCANSET =========== */
 #endif /* SCANF_DISABLE_SUPPORT_SCANSET */
+
+#if SCANF_VIEW
+            case C_('v'): /* non-standard: view of a string or scanset */
+            { /* =========== READ VIEW =========== */
+                /* the field, which is not copied but pointed to */
+                const UCHAR *start = ptr;
+                if (!maxlen) maxlen = SIZE_MAX;
+                /* only input that is all in memory can be pointed into */
+                if (!nostore && in->kind != SI_STRING
+                             && in->kind != SI_BUFFER)
+                    MATCH_FAILURE();
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+                if (d->conv == C_('[')) {
+                    if (!CONVERT(F_(iscans_)(in, &next, &nowread, maxlen,
+                            A_SCANSET, &d->set, 1, NULL)))
+                        MATCH_FAILURE();
+                } else
+#endif
+                if (!CONVERT(F_(iscans_)(in, &next, &nowread, maxlen,
+                                A_STRING, NULL, 1, NULL)))
+                    MATCH_FAILURE();
+                if (!nostore) {
+#if SCANF_WIDE
+                    struct wscanf_view_ *view = (struct wscanf_view_ *)dst;
+#else
+                    struct scanf_view_ *view = (struct scanf_view_ *)dst;
+#endif
+                    view->ptr = (const CHAR *)start;
+                    view->len = nowread;
+                    ++fields;
+                }
+                MATCH_SUCCESS();
+                break;
+            } /* =========== READ VIEW =========== */
+#endif /* SCANF_VIEW */
+
+#if SCANF_SINK
+            case C_('k'): /* non-standard: string, scanset or chars to sink */
+            { /* =========== READ SINK =========== */
+                enum iscans_type ctype = A_STRING;
+                const STRUCT_SCANSET *set = NULL;
+                if (d->conv == C_('c'))
+                    ctype = A_CHAR;
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+                else if (d->conv == C_('['))
+                    ctype = A_SCANSET, set = &d->set;
+#endif
+                if (!maxlen) maxlen = ctype == A_CHAR ? 1 : SIZE_MAX;
+                if (!CONVERT(F_(iscank_)(in, &next, &nowread, maxlen,
+                            ctype, set, (const SSINK_ *)dst)))
+                    MATCH_FAILURE();
+                if (!nostore) ++fields;
+                MATCH_SUCCESS();
+                break;
+            } /* =========== READ SINK =========== */
+#endif /* SCANF_SINK */
+
+#if SCANF_USE_INTERN
+            case C_('y'): /* non-standard: string or scanset to dictionary */
+            { /* =========== READ INTERNED =========== */
+                enum iscans_type ctype = A_STRING;
+                const STRUCT_SCANSET *set = NULL;
+                /* the dictionary comes first, then where the ID goes */
+                unsigned *id = nostore ? NULL : va_arg(va, unsigned *);
+#if !SCANF_DISABLE_SUPPORT_SCANSET
+                if (d->conv == C_('['))
+                    ctype = A_SCANSET, set = &d->set;
+#endif
+                if (!maxlen) maxlen = SIZE_MAX;
+                if (!CONVERT(F_(iscany_)(in, &next, &nowread, maxlen,
+                            ctype, set, (SDICT_ *)dst, id)))
+                    MATCH_FAILURE();
+                if (!nostore) ++fields;
+                MATCH_SUCCESS();
+                break;
+            } /* =========== READ INTERNED =========== */
+#endif /* SCANF_USE_INTERN */
+
+#if SCANF_KEYWORDS
+            case C_('{'): /* non-standard: one of a list of keywords */
+                if (!maxlen) maxlen = SIZE_MAX;
+                if (!CONVERT(F_(iscane_)(in, &next, &nowread, maxlen,
+                            d->keys, d->text, (int *)dst)))
+                    MATCH_FAILURE();
+                if (!nostore) ++fields;
+                MATCH_SUCCESS();
+                break;
+#endif /* SCANF_KEYWORDS */
             default:
                 /* unrecognized specification */
                 MATCH_FAILURE();
             }
 
-            ++f; /* next fmt char */
             read_chars += nowread;
         }
+        }
     }
+done:
 read_failure:
     /* if we have a leftover character, put it back into the stream */
-    if (!GOT_EOF() && ungetch)
-        ungetch(next, p);
+    SAVE_INPUT();
+    F_(sfinish_)(in);
+#if SCANF_FORMAT_CACHE
+    if (cached)
+        --cached->busy;
+#endif
     return tryconv && noconv ? EOF : fields;
 }
 
@@ -1946,10 +6123,54 @@ read_failure:
  *        wrapper functions        *
  * =============================== */
 
-static CINT F_(sscanw_)(void *arg) {
-    const UCHAR **p = (const UCHAR **)arg;
-    const UCHAR c = *(*p)++;
-    return c ? c : GCEOF;
+/* scan from a getch/ungetch pair */
+static int F_(igscanf_)(CINT (*getch)(void *data),
+                        void (*ungetch)(CINT c, void *data),
+                        void *data, const CHAR *format,
+                        const struct F_(sdir_) *prog, va_list arg) {
+    struct F_(sinput_) in;
+    F_(sinit_)(&in, SI_GETCH, data);
+    in.getch = getch;
+    in.ungetch = ungetch;
+    return F_(iscanf_)(&in, format, prog, arg);
+}
+
+/* scan from a refill/consume pair */
+static int F_(ibscanf_)(size_t (*refill)(const CHAR **buf, void *data),
+                        void (*consume)(size_t n, void *data),
+                        void *data, const CHAR *format, va_list arg) {
+    struct F_(sinput_) in;
+    F_(sinit_)(&in, SI_BLOCK, data);
+    in.refill = refill;
+    in.consume = consume;
+    return F_(iscanf_)(&in, format, NULL, arg);
+}
+
+/* scan a null-terminated string, updating *sp past the consumed part */
+static int F_(isscanf_)(const CHAR **sp, const CHAR *format,
+                        const struct F_(sdir_) *prog, va_list arg) {
+    struct F_(sinput_) in;
+    int r;
+    F_(sinit_)(&in, SI_STRING, NULL);
+    in.ptr = in.begin = (const UCHAR *)*sp;
+    in.end = NULL;
+    r = F_(iscanf_)(&in, format, prog, arg);
+    *sp = (const CHAR *)in.ptr;
+    return r;
+}
+
+/* scan *n characters at *sp, updating both past the consumed part */
+static int F_(isnscanf_)(const CHAR **sp, size_t *n, const CHAR *format,
+                         va_list arg) {
+    struct F_(sinput_) in;
+    int r;
+    F_(sinit_)(&in, SI_BUFFER, NULL);
+    in.ptr = in.begin = (const UCHAR *)*sp;
+    in.end = in.begin + *n;
+    r = F_(iscanf_)(&in, format, NULL, arg);
+    *n -= (size_t)(in.ptr - (const UCHAR *)*sp);
+    *sp = (const CHAR *)in.ptr;
+    return r;
 }
 
 #if SCANF_WIDE
@@ -1964,6 +6185,19 @@ int wscanf_(const WCHAR *format, ...) {
     return *format ? EOF : 0;
 }
 
+int vwscanf_exec_(const void *prog, va_list arg) {
+    return ((const struct F_(sdir_) *)prog)->kind != OP_END ? EOF : 0;
+}
+
+int wscanf_exec_(const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vwscanf_exec_(prog, va);
+    va_end(va);
+    return r;
+}
+
 #else /* SCANF_SSCANF_ONLY */
 
 static WINT getwchw_(void *arg) {
@@ -1977,7 +6211,7 @@ static void ungetwchw_(WINT c, void *arg) {
 }
 
 int vwscanf_(const WCHAR *format, va_list arg) {
-    return F_(iscanf_)(&getwchw_, &ungetwchw_, NULL, format, arg);
+    return F_(igscanf_)(&getwchw_, &ungetwchw_, NULL, format, NULL, arg);
 }
 
 int wscanf_(const WCHAR *format, ...) {
@@ -1989,14 +6223,24 @@ int wscanf_(const WCHAR *format, ...) {
     return r;
 }
 
+int vwscanf_exec_(const void *prog, va_list arg) {
+    return F_(igscanf_)(&getwchw_, &ungetwchw_, NULL, NULL,
+                        (const struct F_(sdir_) *)prog, arg);
+}
+
+int wscanf_exec_(const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vwscanf_exec_(prog, va);
+    va_end(va);
+    return r;
+}
+
 #endif /* SCANF_SSCANF_ONLY */
 
 int vspwscanf_(const WCHAR **sp, const WCHAR *format, va_list arg) {
-    int i = F_(iscanf_)(&F_(sscanw_), NULL, sp, format, arg);
-    /* ungetch = NULL, because see below */
-    --*sp; /* back up by one character, even if it was EOF we want the pointer
-              at the null terminator */
-    return i;
+    return F_(isscanf_)(sp, format, NULL, arg);
 }
 
 int spwscanf_(const WCHAR **sp, const WCHAR *format, ...) {
@@ -2009,7 +6253,7 @@ int spwscanf_(const WCHAR **sp, const WCHAR *format, ...) {
 }
 
 int vswscanf_(const WCHAR *s, const WCHAR *format, va_list arg) {
-    return F_(iscanf_)(&F_(sscanw_), NULL, &s, format, arg);
+    return F_(isscanf_)(&s, format, NULL, arg);
 }
 
 int swscanf_(const WCHAR *s, const WCHAR *format, ...) {
@@ -2021,10 +6265,37 @@ int swscanf_(const WCHAR *s, const WCHAR *format, ...) {
     return r;
 }
 
+int vspnwscanf_(const WCHAR **sp, size_t *n, const WCHAR *format,
+                va_list arg) {
+    return F_(isnscanf_)(sp, n, format, arg);
+}
+
+int spnwscanf_(const WCHAR **sp, size_t *n, const WCHAR *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vspnwscanf_(sp, n, format, va);
+    va_end(va);
+    return r;
+}
+
+int vsnwscanf_(const WCHAR *s, size_t n, const WCHAR *format, va_list arg) {
+    return F_(isnscanf_)(&s, &n, format, arg);
+}
+
+int snwscanf_(const WCHAR *s, size_t n, const WCHAR *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vsnwscanf_(s, n, format, va);
+    va_end(va);
+    return r;
+}
+
 int vfctwscanf_(WINT (*getwch)(void *data),
                 void (*ungetwch)(WINT c, void *data),
                 void *data, const WCHAR *format, va_list arg) {
-    return F_(iscanf_)(getwch, ungetwch, data, format, arg);
+    return F_(igscanf_)(getwch, ungetwch, data, format, NULL, arg);
 }
 
 int fctwscanf_(WINT (*getwch)(void *data),
@@ -2038,11 +6309,92 @@ int fctwscanf_(WINT (*getwch)(void *data),
     return r;
 }
 
+int vbufwscanf_(size_t (*refill)(const WCHAR **buf, void *data),
+                void (*consume)(size_t n, void *data),
+                void *data, const WCHAR *format, va_list arg) {
+    return F_(ibscanf_)(refill, consume, data, format, arg);
+}
+
+int bufwscanf_(size_t (*refill)(const WCHAR **buf, void *data),
+                void (*consume)(size_t n, void *data),
+                void *data, const WCHAR *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vbufwscanf_(refill, consume, data, format, va);
+    va_end(va);
+    return r;
+}
+
+size_t wscanf_compile_(void *buf, size_t size, const WCHAR *format) {
+    return F_(icompile_)(buf, size, format);
+}
+
+void wscanf_cache_stats_(unsigned long *hits, unsigned long *misses) {
+#if SCANF_FORMAT_CACHE
+    *hits = F_(cache_).hits, *misses = F_(cache_).misses;
+#else
+    *hits = *misses = 0;
+#endif
+}
+
+#if SCANF_USE_INTERN
+void wscanf_dict_init_(struct wscanf_dict_ *d) {
+    F_(sdinit_)(d);
+}
+
+void wscanf_dict_free_(struct wscanf_dict_ *d) {
+    F_(sdfree_)(d);
+}
+
+int wscanf_dict_intern_(struct wscanf_dict_ *d, const WCHAR *s, size_t n,
+                        unsigned *id) {
+    return F_(sdintern_)(d, s, n, id);
+}
+
+const WCHAR *wscanf_dict_get_(const struct wscanf_dict_ *d, unsigned id,
+                              size_t *n) {
+    return F_(sdget_)(d, id, n);
+}
+
+int wscanf_dict_merge_(struct wscanf_dict_ *d,
+                       const struct wscanf_dict_ *from, unsigned *map) {
+    return F_(sdmerge_)(d, from, map);
+}
+#endif /* SCANF_USE_INTERN */
+
+int vspwscanf_exec_(const WCHAR **sp, const void *prog, va_list arg) {
+    return F_(isscanf_)(sp, NULL, (const struct F_(sdir_) *)prog, arg);
+}
+
+int spwscanf_exec_(const WCHAR **sp, const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vspwscanf_exec_(sp, prog, va);
+    va_end(va);
+    return r;
+}
+
+int vswscanf_exec_(const WCHAR *s, const void *prog, va_list arg) {
+    return F_(isscanf_)(&s, NULL, (const struct F_(sdir_) *)prog, arg);
+}
+
+int swscanf_exec_(const WCHAR *s, const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vswscanf_exec_(s, prog, va);
+    va_end(va);
+    return r;
+}
+
 #else /* SCANF_WIDE */
 
 #if SCANF_SSCANF_ONLY
 
 int vscanf_(const char *format, va_list arg) {
+    (void)arg;
     return *format ? EOF : 0;
 }
 
@@ -2050,6 +6402,20 @@ int scanf_(const char *format, ...) {
     return *format ? EOF : 0;
 }
 
+int vscanf_exec_(const void *prog, va_list arg) {
+    (void)arg;
+    return ((const struct F_(sdir_) *)prog)->kind != OP_END ? EOF : 0;
+}
+
+int scanf_exec_(const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vscanf_exec_(prog, va);
+    va_end(va);
+    return r;
+}
+
 #else /* SCANF_SSCANF_ONLY */
 
 static int getchw_(void *arg) {
@@ -2063,7 +6429,7 @@ static void ungetchw_(int c, void *arg) {
 }
 
 int vscanf_(const char *format, va_list arg) {
-    return iscanf_(&getchw_, &ungetchw_, NULL, format, arg);
+    return igscanf_(&getchw_, &ungetchw_, NULL, format, NULL, arg);
 }
 
 int scanf_(const char *format, ...) {
@@ -2075,13 +6441,24 @@ int scanf_(const char *format, ...) {
     return r;
 }
 
+int vscanf_exec_(const void *prog, va_list arg) {
+    return igscanf_(&getchw_, &ungetchw_, NULL, NULL,
+                        (const struct F_(sdir_) *)prog, arg);
+}
+
+int scanf_exec_(const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vscanf_exec_(prog, va);
+    va_end(va);
+    return r;
+}
+
 #endif /* SCANF_SSCANF_ONLY */
 
 int vspscanf_(const char **sp, const char *format, va_list arg) {
-    int i = iscanf_(&F_(sscanw_), NULL, sp, format, arg);
-    --*sp; /* back up by one character, even if it was EOF we want the pointer
-              at the null terminator */
-    return i;
+    return isscanf_(sp, format, NULL, arg);
 }
 
 int spscanf_(const char **sp, const char *format, ...) {
@@ -2094,7 +6471,7 @@ int spscanf_(const char **sp, const char *format, ...) {
 }
 
 int vsscanf_(const char *s, const char *format, va_list arg) {
-    return iscanf_(&F_(sscanw_), NULL, &s, format, arg);
+    return isscanf_(&s, format, NULL, arg);
 }
 
 int sscanf_(const char *s, const char *format, ...) {
@@ -2106,9 +6483,35 @@ int sscanf_(const char *s, const char *format, ...) {
     return r;
 }
 
+int vspnscanf_(const char **sp, size_t *n, const char *format, va_list arg) {
+    return isnscanf_(sp, n, format, arg);
+}
+
+int spnscanf_(const char **sp, size_t *n, const char *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vspnscanf_(sp, n, format, va);
+    va_end(va);
+    return r;
+}
+
+int vsnscanf_(const char *s, size_t n, const char *format, va_list arg) {
+    return isnscanf_(&s, &n, format, arg);
+}
+
+int snscanf_(const char *s, size_t n, const char *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vsnscanf_(s, n, format, va);
+    va_end(va);
+    return r;
+}
+
 int vfctscanf_(int (*getch)(void *data), void (*ungetch)(int c, void *data),
                 void *data, const char *format, va_list arg) {
-    return iscanf_(getch, ungetch, data, format, arg);
+    return igscanf_(getch, ungetch, data, format, NULL, arg);
 }
 
 int fctscanf_(int (*getch)(void *data), void (*ungetch)(int c, void *data),
@@ -2121,6 +6524,86 @@ int fctscanf_(int (*getch)(void *data), void (*ungetch)(int c, void *data),
     return r;
 }
 
+int vbufscanf_(size_t (*refill)(const char **buf, void *data),
+                void (*consume)(size_t n, void *data),
+                void *data, const char *format, va_list arg) {
+    return ibscanf_(refill, consume, data, format, arg);
+}
+
+int bufscanf_(size_t (*refill)(const char **buf, void *data),
+                void (*consume)(size_t n, void *data),
+                void *data, const char *format, ...) {
+    int r;
+    va_list va;
+    va_start(va, format);
+    r = vbufscanf_(refill, consume, data, format, va);
+    va_end(va);
+    return r;
+}
+
+size_t scanf_compile_(void *buf, size_t size, const char *format) {
+    return icompile_(buf, size, format);
+}
+
+void scanf_cache_stats_(unsigned long *hits, unsigned long *misses) {
+#if SCANF_FORMAT_CACHE
+    *hits = cache_.hits, *misses = cache_.misses;
+#else
+    *hits = *misses = 0;
+#endif
+}
+
+#if SCANF_USE_INTERN
+void scanf_dict_init_(struct scanf_dict_ *d) {
+    F_(sdinit_)(d);
+}
+
+void scanf_dict_free_(struct scanf_dict_ *d) {
+    F_(sdfree_)(d);
+}
+
+int scanf_dict_intern_(struct scanf_dict_ *d, const char *s, size_t n,
+                       unsigned *id) {
+    return F_(sdintern_)(d, s, n, id);
+}
+
+const char *scanf_dict_get_(const struct scanf_dict_ *d, unsigned id,
+                            size_t *n) {
+    return F_(sdget_)(d, id, n);
+}
+
+int scanf_dict_merge_(struct scanf_dict_ *d,
+                      const struct scanf_dict_ *from, unsigned *map) {
+    return F_(sdmerge_)(d, from, map);
+}
+#endif /* SCANF_USE_INTERN */
+
+int vspscanf_exec_(const char **sp, const void *prog, va_list arg) {
+    return isscanf_(sp, NULL, (const struct F_(sdir_) *)prog, arg);
+}
+
+int spscanf_exec_(const char **sp, const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vspscanf_exec_(sp, prog, va);
+    va_end(va);
+    return r;
+}
+
+int vsscanf_exec_(const char *s, const void *prog, va_list arg) {
+    return isscanf_(&s, NULL, (const struct F_(sdir_) *)prog, arg);
+}
+
+int sscanf_exec_(const char *s, const void *prog, ...) {
+    int r;
+    va_list va;
+    va_start(va, prog);
+    r = vsscanf_exec_(s, prog, va);
+    va_end(va);
+    return r;
+}
+
 #endif /* SCANF_WIDE */
 
 #if SCANF_WIDE >= 2
@@ -28,6 +28,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SCANF_H
 
 #include <stdarg.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,35 +38,116 @@ extern "C" {
 #define ATTR_scanf     __attribute__ ((format (scanf, 1, 2)))
 #define ATTR_sscanf    __attribute__ ((format (scanf, 2, 3)))
 #define ATTR_spscanf   __attribute__ ((format (scanf, 2, 3)))
+#define ATTR_snscanf   __attribute__ ((format (scanf, 3, 4)))
+#define ATTR_spnscanf  __attribute__ ((format (scanf, 3, 4)))
 #define ATTR_fctscanf  __attribute__ ((format (scanf, 4, 5)))
+#define ATTR_bufscanf  __attribute__ ((format (scanf, 4, 5)))
 #define ATTR_vscanf    __attribute__ ((format (scanf, 1, 0)))
 #define ATTR_vsscanf   __attribute__ ((format (scanf, 2, 0)))
 #define ATTR_vspscanf  __attribute__ ((format (scanf, 2, 0)))
+#define ATTR_vsnscanf  __attribute__ ((format (scanf, 3, 0)))
+#define ATTR_vspnscanf __attribute__ ((format (scanf, 3, 0)))
 #define ATTR_vfctscanf __attribute__ ((format (scanf, 4, 0)))
+#define ATTR_vbufscanf __attribute__ ((format (scanf, 4, 0)))
 #else
 #define ATTR_scanf
 #define ATTR_sscanf
 #define ATTR_spscanf
+#define ATTR_snscanf
+#define ATTR_spnscanf
 #define ATTR_fctscanf
+#define ATTR_bufscanf
 #define ATTR_vscanf
 #define ATTR_vsscanf
 #define ATTR_vspscanf
+#define ATTR_vsnscanf
+#define ATTR_vspnscanf
 #define ATTR_vfctscanf
+#define ATTR_vbufscanf
 #endif
 
 ATTR_scanf int scanf_(const char *format, ...);
 ATTR_sscanf int sscanf_(const char *s, const char *format, ...);
 ATTR_spscanf int spscanf_(const char **sp, const char *format, ...);
+ATTR_snscanf int snscanf_(const char *s, size_t n, const char *format, ...);
+ATTR_spnscanf int spnscanf_(const char **sp, size_t *n,
+                            const char *format, ...);
 ATTR_fctscanf int fctscanf_(int (*getch)(void *data),
                          void (*ungetch)(int c, void *data),
                          void *data, const char *format, ...);
+ATTR_bufscanf int bufscanf_(size_t (*refill)(const char **buf, void *data),
+                            void (*consume)(size_t n, void *data),
+                            void *data, const char *format, ...);
 
 ATTR_vscanf int vscanf_(const char *format, va_list arg);
 ATTR_vsscanf int vsscanf_(const char *s, const char *format, va_list arg);
 ATTR_vspscanf int vspscanf_(const char **sp, const char *format, va_list arg);
+ATTR_vsnscanf int vsnscanf_(const char *s, size_t n, const char *format,
+                            va_list arg);
+ATTR_vspnscanf int vspnscanf_(const char **sp, size_t *n, const char *format,
+                              va_list arg);
 ATTR_vfctscanf int vfctscanf_(int (*getch)(void *data),
                               void (*ungetch)(int c, void *data),
                               void *data, const char *format, va_list arg);
+ATTR_vbufscanf int vbufscanf_(size_t (*refill)(const char **buf, void *data),
+                              void (*consume)(size_t n, void *data),
+                              void *data, const char *format, va_list arg);
+
+/* compiled formats */
+size_t scanf_compile_(void *buf, size_t size, const char *format);
+int scanf_exec_(const void *prog, ...);
+int sscanf_exec_(const char *s, const void *prog, ...);
+int spscanf_exec_(const char **sp, const void *prog, ...);
+int vscanf_exec_(const void *prog, va_list arg);
+int vsscanf_exec_(const char *s, const void *prog, va_list arg);
+int vspscanf_exec_(const char **sp, const void *prog, va_list arg);
+
+/* format cache */
+void scanf_cache_stats_(unsigned long *hits, unsigned long *misses);
+
+/* allocator for %ms, %m[ and %mc on the current thread: resizes p (NULL
+   for a new block) from oldsize to size bytes, frees it if size is 0, and
+   returns the new block or NULL if it cannot. NULL sets the default */
+void scanf_set_allocator_(void *(*resize)(void *data, void *p,
+                                          size_t oldsize, size_t size),
+                          void *data);
+
+/* a string read in place by %v or %v[, valid for as long as the input is */
+struct scanf_view_ {
+    const char *ptr;
+    size_t len;
+};
+
+/* where %k, %k[ and %kc send what they read: write is called with the data
+   and each chunk of the field, and returns nonzero to stop reading it */
+struct scanf_sink_ {
+    int (*write)(void *data, const char *p, size_t n);
+    void *data;
+};
+
+/* a dictionary for %y and %y[, which give every distinct string read into it
+   an ID, counting from 0. the strings are kept one after the other, each
+   terminated, in text; offs[id] is where each starts. only the dictionary
+   functions should change it. it uses the allocator of the thread that set
+   it up, and the same one may not be used by two threads at once */
+struct scanf_dict_ {
+    unsigned count;
+    char *text;
+    size_t *offs;
+    unsigned *table;
+    size_t textlen, textcap, offscap, tablecap;
+    void *(*resize)(void *data, void *p, size_t oldsize, size_t size);
+    void *data;
+};
+
+void scanf_dict_init_(struct scanf_dict_ *d);
+void scanf_dict_free_(struct scanf_dict_ *d);
+int scanf_dict_intern_(struct scanf_dict_ *d, const char *s, size_t n,
+                       unsigned *id);
+const char *scanf_dict_get_(const struct scanf_dict_ *d, unsigned id,
+                            size_t *n);
+int scanf_dict_merge_(struct scanf_dict_ *d, const struct scanf_dict_ *from,
+                      unsigned *map);
 
 int getch_(void);
 void ungetch_(int);
@@ -79,9 +161,32 @@ void ungetch_(int);
 #endif
 
 #define spscanf spscanf_
+#define snscanf snscanf_
+#define spnscanf spnscanf_
 #define fctscanf fctscanf_
 #define vspscanf vspscanf_
+#define vsnscanf vsnscanf_
+#define vspnscanf vspnscanf_
 #define vfctscanf vfctscanf_
+#define bufscanf bufscanf_
+#define vbufscanf vbufscanf_
+#define scanf_compile scanf_compile_
+#define scanf_exec scanf_exec_
+#define sscanf_exec sscanf_exec_
+#define spscanf_exec spscanf_exec_
+#define vscanf_exec vscanf_exec_
+#define vsscanf_exec vsscanf_exec_
+#define vspscanf_exec vspscanf_exec_
+#define scanf_cache_stats scanf_cache_stats_
+#define scanf_view scanf_view_
+#define scanf_sink scanf_sink_
+#define scanf_dict scanf_dict_
+#define scanf_dict_init scanf_dict_init_
+#define scanf_dict_free scanf_dict_free_
+#define scanf_dict_intern scanf_dict_intern_
+#define scanf_dict_get scanf_dict_get_
+#define scanf_dict_merge scanf_dict_merge_
+#define scanf_set_allocator scanf_set_allocator_
 #endif
 
 #ifdef __cplusplus
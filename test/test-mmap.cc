@@ -0,0 +1,141 @@
+/*
+
+scanf implementation -- test program for mmap/posix
+Copyright (C) 2021 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining
+a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including
+without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to
+permit persons to whom the Software is furnished to do so, subject to
+the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+*/
+
+#include <iostream>
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../scanf.h"
+
+namespace test {
+/* map one page at a time, so that records cross the edges of windows */
+#define SCANF_MMAP_WINDOW ((size_t)sysconf(_SC_PAGESIZE))
+#include "../scanf.c"
+#include "../mmap/posix/scanf_mmap.c"
+extern "C" {
+int getch_() {
+    return -1;
+}
+
+void ungetch_(int) { }
+}
+
+int scnext_(int (*getch)(void *data), void *data, const char **format,
+            int *buffer, int length, int nostore, void *destination) {
+    return 1;
+}
+};
+
+/* records of different lengths, so that they end at every offset */
+const int records = 2000;
+
+bool tests_ok() {
+    std::cout << "Running scanf_mmap tests..." << std::endl;
+    int tests = 0;
+    char path[] = "/tmp/test-mmap-XXXXXX";
+    int fd = mkstemp(path);
+    FILE *f = fd < 0 ? NULL : fdopen(fd, "w");
+    if (!f) {
+        std::cout << "could not create a temporary file!" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < records; ++i)
+        std::fprintf(f, "%d %.*s\n", i, i % 23 + 1,
+                     "abcdefghijklmnopqrstuvwxyz");
+    std::fclose(f);
+
+    /* every record should be read whole, also across windows */
+    test::scanf_mmap *m = test::scanf_mmap_open(path);
+    if (!m) {
+        std::cout << "scanf_mmap_open!" << std::endl;
+        std::remove(path);
+        return false;
+    }
+    int i, id, r = 0;
+    char name[32];
+    for (i = 0; (r = test::scanf_mmap_next(m, "%d %31s\n", &id, name)) == 2;
+            ++i) {
+        if (id != i || std::strlen(name) != (std::size_t)(i % 23 + 1)
+                    || std::strncmp(name, "abcdefghijklmnopqrstuvwxyz",
+                                    i % 23 + 1)) {
+            std::cout << "scanf_mmap_next record " << i << "!" << std::endl;
+            test::scanf_mmap_close(m);
+            std::remove(path);
+            return false;
+        }
+    }
+    if (i != records || r != EOF
+            || m->size <= 4 * (off_t)sysconf(_SC_PAGESIZE)) {
+        std::cout << "scanf_mmap_next windows!" << std::endl;
+        test::scanf_mmap_close(m);
+        std::remove(path);
+        return false;
+    }
+    test::scanf_mmap_close(m);
+    ++tests;
+
+    /* a failed mapping should not look like the end of the file */
+    m = test::scanf_mmap_open(path);
+    std::remove(path);
+    if (!m) {
+        std::cout << "scanf_mmap_open!" << std::endl;
+        return false;
+    }
+    close(m->fd);
+    m->fd = -1;
+    r = test::scanf_mmap_next(m, "%d", &id);
+    if (r != SCANF_MMAP_ERROR || r == EOF || m->err != EBADF
+            || test::scanf_mmap_next(m, "%d", &id) != SCANF_MMAP_ERROR) {
+        std::cout << "scanf_mmap_next error!" << std::endl;
+        test::scanf_mmap_close(m);
+        return false;
+    }
+    test::scanf_mmap_close(m);
+    ++tests;
+
+    std::cout << "==========\n"
+                 "  ALL OK  \n"
+                 "==========" << std::endl;
+    std::cout << "Ran " << tests << " tests" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    return tests_ok() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
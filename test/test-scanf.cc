@@ -28,6 +28,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <any>
 #include <iomanip>
 #include <iostream>
+#include <string>
 #include <tuple>
 
 #include <cctype>
@@ -267,6 +268,26 @@ bool run_test(const std::string& name, int n, int c, const std::string& input,
         ++tests;                                                               \
     } while (0);
 
+/* block source handing out the input a few characters at a time */
+struct chunked_input {
+    const char *s;
+    std::size_t len, pos, last, step;
+};
+
+std::size_t chunked_refill(const char **buf, void *data) {
+    chunked_input *ci = static_cast<chunked_input *>(data);
+    ci->pos += ci->last;
+    ci->last = std::min(ci->step, ci->len - ci->pos);
+    *buf = ci->s + ci->pos;
+    return ci->last;
+}
+
+void chunked_consume(std::size_t n, void *data) {
+    chunked_input *ci = static_cast<chunked_input *>(data);
+    ci->pos += n;
+    ci->last = 0;
+}
+
 /* 1, 2, "42", "%d", int(42)... =
     {
         int t0;
@@ -382,6 +403,24 @@ bool tests_ok() {
     TRY_TEST("%i failure mode",
         2, 2, "09", "%i%d", int(0), int(9));
 
+    TRY_TEST("long %llu",
+        1, 19, "1234567890123456789", "%llu",
+        (unsigned long long)(1234567890123456789ULL));
+
+    TRY_TEST("long %llx",
+        1, 16, "0123456789abcDEF", "%llx",
+        (unsigned long long)(0x0123456789ABCDEFULL));
+
+    TRY_TEST("%llu overflow",
+        1, 20, "30000000000000000000", "%llu",
+        (unsigned long long)(ULLONG_MAX));
+
+    TRY_TEST("%*d overflow",
+        1, 30, "123456789012345678901234567890 7", "%*d%d", int(7));
+
+    TRY_TEST("%hhx%o",
+        2, 8, "0ff 0377", "%hhx%o", (unsigned char)(0xFF), unsigned(0377));
+
     TRY_TEST("%c",
         3, 3, "abc", "%c%c%c", char('a'), char('b'), char('c'));
 
@@ -397,6 +436,10 @@ bool tests_ok() {
     TRY_TEST("%3c",
         1, 3, "ab\ncd", "%3c", buf_char<3>("ab\n"));
 
+    TRY_TEST("long %c",
+        1, 36, "the quick brown fox\njumps over the lazy dog", "%36c",
+        buf_char<36>("the quick brown fox\njumps over the l"));
+
     TRY_TEST("%s",
         1, 3, "abc", "%s", buf_str<20>("abc"));
 
@@ -412,6 +455,11 @@ bool tests_ok() {
     TRY_TEST("%5s",
         2, 6, "abcdef   ghi", "%5s%s", buf_str<20>("abcde"), buf_str<20>("f"));
 
+    TRY_TEST("long %s",
+        2, 50, "/usr/share/doc/scanf/examples/long-names.txt\tx-y-z\v",
+        "%s%s", buf_str<64>("/usr/share/doc/scanf/examples/long-names.txt"),
+        buf_str<64>("x-y-z"));
+
     TRY_TEST("scanset found",
         1, 3, "abc", "%[abc]", buf_str<20>("abc"));
 
@@ -453,6 +501,16 @@ bool tests_ok() {
     TRY_TEST("scanset maxlen",
         2, 4, "39abc", "%2[0-9]%2[a-b]", buf_str<20>("39"), buf_str<20>("ab"));
 
+    TRY_TEST("scanset wide range",
+        1, 9, "Hi there!~", "%[ -z]", buf_str<20>("Hi there!"));
+
+    TRY_TEST("scanset starting with ]",
+        1, 3, "]a]b", "%[]a]", buf_str<20>("]a]"));
+
+    TRY_TEST("scanset long run",
+        1, 45, "the quick brown fox jumps over the lazy dog 0123,4",
+        "%45[^,]", buf_str<64>("the quick brown fox jumps over the lazy dog 0"));
+
 #if !SCANF_DISABLE_SUPPORT_FLOAT
 
     TRY_TEST("%f",
@@ -506,6 +564,55 @@ bool tests_ok() {
     TRY_TEST("%f hex",
         1, 8, "0x0.3p10", "%f", float(192.0f));
 
+    TRY_TEST("%lf rounding",
+        1, 19, "0.30000000000000004", "%lf", double(0.30000000000000004));
+
+    TRY_TEST("%lf tie to even",
+        1, 16, "9007199254740993", "%lf", double(9007199254740992.0));
+
+    TRY_TEST("%lf just above tie",
+        1, 30, "9007199254740993.0000000000001", "%lf",
+        double(9007199254740994.0));
+
+    TRY_TEST("%f no double rounding",
+        1, 25, "6.5417843346470066173e-28", "%f",
+        float(6.5417843346470066173e-28f));
+
+    TRY_TEST("%lf subnormal",
+        1, 23, "2.4703282292062328e-324", "%lf",
+        double(4.9406564584124654e-324));
+
+    TRY_TEST("%la tie to even",
+        1, 20, "0x1.00000000000008p0", "%la", double(1.0));
+
+    TRY_TEST("%la sticky",
+        1, 29, "0x1.00000000000008000000001p0", "%la",
+        double(1.0000000000000002));
+
+    TRY_TEST("%a subnormal",
+        1, 10, "0x1.8p-149", "%a", float(2.80259693e-45f));
+
+#if SCANF_USE_FLOAT16
+    TRY_TEST("%Hf",
+        1, 3, "1.5", "%Hf", (unsigned short)0x3E00);
+
+    TRY_TEST("%Hf subnormal tie to even",
+        1, 22, "2.98023223876953125e-8", "%Hf", (unsigned short)0x0000);
+
+    TRY_TEST("%Hf overflow",
+        1, 5, "65520", "%Hf", (unsigned short)0x7C00);
+
+    TRY_TEST("%Ha",
+        1, 11, "-0x1.ffcp15", "%Ha", (unsigned short)0xFBFF);
+
+    TRY_TEST("%Bf",
+        1, 7, "3.14159", "%Bf", (unsigned short)0x4049);
+
+    TRY_TEST("%Hd",
+        0, 0, "1", "%Hd", (unsigned short)0);
+
+#endif
+
 #if SCANF_INFINITE
     TRY_TEST("%f inf",
         1, 3, "inf", "%f", float(INFINITY));
@@ -532,6 +639,64 @@ bool tests_ok() {
     TRY_TEST("%b",
         1, 10, "1001101001", "%b", (int)617);
 
+#endif
+#if SCANF_FIXED_POINT
+    TRY_TEST("%.2D",
+        1, 8, "12345.67", "%.2D", int(1234567));
+
+    TRY_TEST("%.2D padded",
+        2, 6, "-3.5 7", "%.2D%.2D", int(-350), int(700));
+
+    TRY_TEST("%.2D sticky",
+        1, 9, "0.1250001 0.125", "%.2D", int(13));
+
+    TRY_TEST("%.1D tie to even",
+        2, 10, "0.25 -0.35", "%.1D%.1D", int(2), int(-4));
+
+    TRY_TEST("%.3jD overflow",
+        1, 20, "99999999999999999999", "%.3jD", intmax_t(INTMAX_MAX));
+
+    TRY_TEST("%D no digits",
+        0, 1, ".e", "%D", int(0));
+
+#endif
+
+#if SCANF_GROUPING
+    TRY_TEST("%'d",
+        2, 13, "1,234,567 -89", "%'d%'d", int(1234567), int(-89));
+
+    TRY_TEST("%'d separator not followed by a digit",
+        2, 5, "12,,3", "%'d,,%d", int(12), int(3));
+
+    TRY_TEST("%'d group of fewer than three digits",
+        2, 4, "12,3", "%'d,%d", int(12), int(3));
+
+    TRY_TEST("%'d group of more than three digits",
+        2, 6, "1,2345", "%'d,%d", int(1), int(2345));
+
+    TRY_TEST("%'d groups of three after a short one",
+        3, 6, "1,23,4", "%'d,%d,%d", int(1), int(23), int(4));
+
+    TRY_TEST("%'d first group of more than three digits",
+        2, 8, "1234,567", "%'d,%d", int(1234), int(567));
+
+    TRY_TEST("%'d width ending a group",
+        2, 6, "1,2345", "%'5d%d", int(1234), int(5));
+
+    TRY_TEST("%'d width cutting a group",
+        2, 5, "1,234", "%'4d,%d", int(1), int(234));
+
+    TRY_TEST("%d without grouping",
+        1, 1, "1,234", "%d", int(1));
+
+    TRY_TEST("%'lf",
+        1, 11, "1,234,567.5", "%'lf", double(1234567.5));
+
+    TRY_TEST("%'lf group of fewer than three digits",
+        2, 6, "1,23.5", "%'lf,%lf", double(1), double(23.5));
+
+    TRY_TEST("%'x fails",
+        0, 0, "1,234", "%'x", unsigned(0));
 #endif
 
     TRY_TEST("literal",
@@ -575,6 +740,10 @@ bool tests_ok() {
         2, 12, "  abc      2bb", "%s%n%d%n",
             buf_str<3>("abc"), int(5), int(2), int(12));
 
+    TRY_TEST("%n after long whitespace",
+        2, 42, "x \t\n                                     7", "%c %n%d%n",
+            char('x'), int(41), int(7), int(42));
+
 #if !SCANF_DISABLE_SUPPORT_FLOAT
 
     TRY_TEST("%n after %f",
@@ -612,7 +781,7 @@ bool tests_ok() {
 
     /* finally */
     const char *s = "23abc", *sp = s;
-    int j;
+    int j, k, l;
     char buf[4];
     if (1 != test::spscanf_(&sp, "%d", &j))
         std::terminate();
@@ -624,6 +793,231 @@ bool tests_ok() {
     }
     ++tests;
 
+    /* length-bounded input must not be read past its end */
+    const char *buf3 = "12345 67", *sp3 = buf3;
+    std::size_t n3 = 7;
+    if (1 != test::snscanf_(buf3, 3, "%d", &j) || j != 123) {
+        std::cout << "snscanf length!" << std::endl;
+        return false;
+    }
+    if (2 != test::spnscanf_(&sp3, &n3, "%d%d", &j, &k)
+            || j != 12345 || k != 6 || sp3 != buf3 + 7 || n3 != 0) {
+        std::cout << "spnscanf consumed!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+    /* windows should be stitched together and the rest given back */
+    chunked_input ci = { "123 abcdef 45x", 14, 0, 0, 2 };
+    char buf2[8];
+    if (3 != test::bufscanf_(&chunked_refill, &chunked_consume, &ci,
+                             "%d %7s%d", &k, buf2, &l)
+            || k != 123 || l != 45 || std::strcmp(buf2, "abcdef")
+            || ci.pos != 13) {
+        std::cout << "bufscanf windows!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#if SCANF_GROUPING
+    /* a separator at the end of a window cannot be looked past, so it is
+       read, and a bad group after it fails the number */
+    chunked_input gi = { "1,234,567 1,23 ", 15, 0, 0, 2 };
+    k = l = 0;
+    if (1 != test::bufscanf_(&chunked_refill, &chunked_consume, &gi,
+                             "%'d %'d", &k, &l)
+            || k != 1234567 || l != 0 || gi.pos != 14) {
+        std::cout << "bufscanf digit groups!" << std::endl;
+        return false;
+    }
+    ++tests;
+#endif
+
+#if SCANF_USE_FLOAT16
+    /* arrays of 16-bit floats should fill every element */
+    const char *hs = "1 -2 0.5x", *hsp = hs;
+    unsigned short h[4] = { 0, 0, 0, 0 };
+    if (1 != test::spscanf_(&hsp, "%.3Hf", h) || hsp != hs + 8
+            || h[0] != 0x3C00 || h[1] != 0xC000 || h[2] != 0x3800 || h[3]
+            || 0 != test::sscanf_("1 2", "%.3Bf", h) || h[1] != 0x4000) {
+        std::cout << "float16 array!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+#if SCANF_USE_INT128
+    /* 128-bit integers should not stop at 64 bits */
+    unsigned __int128 u128;
+    __int128 i128;
+    if (2 != test::sscanf_("-170141183460469231731687303715884105728 "
+                           "0x123456789abcdef0fedcba9876543210",
+                           "%w128d%w128x", &i128, &u128)
+            || i128 != -(__int128)(~(unsigned __int128)0 >> 1) - 1
+            || (std::uint64_t)(u128 >> 64) != 0x123456789abcdef0ULL
+            || (std::uint64_t)u128 != 0xfedcba9876543210ULL
+            || 1 != test::sscanf_("340282366920938463463374607431768211456",
+                                  "%w128u", &u128)
+            || ~u128 || 0 != test::sscanf_("1", "%w64d", &i128)) {
+        std::cout << "128-bit integers!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+#if SCANF_VIEW
+    /* views should point into the input */
+    const char *vs = " key=value;rest";
+    struct scanf_view_ vk, vv;
+    if (2 != test::sscanf_(vs, " %v[^=]=%v[^;]", &vk, &vv)
+            || vk.ptr != vs + 1 || vk.len != 3
+            || vv.ptr != vs + 5 || vv.len != 5
+            || 1 != test::sscanf_(vs, "%v", &vk) || vk.len != 14
+            || 0 != test::sscanf_(vs, "%lv", &vk)) {
+        std::cout << "views!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+#if SCANF_SINK
+    /* sinks should get all of the field, in order */
+    std::string sunk;
+    struct scanf_sink_ sink = {
+        [](void *data, const char *p, std::size_t n) {
+            static_cast<std::string *>(data)->append(p, n);
+            return 0;
+        }, &sunk };
+    if (2 != test::sscanf_(" ab cde:f", "%k %k[^:]", &sink, &sink)
+            || sunk != "abcde") {
+        std::cout << "sinks!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+#if SCANF_ALLOC
+    /* %m should allocate exactly what was read */
+    char *ms, *mb;
+    if (2 != test::sscanf_(" abc de:f", "%ms %m[^:]", &ms, &mb)
+            || std::strcmp(ms, "abc") || std::strcmp(mb, "de")) {
+        std::cout << "%m!" << std::endl;
+        return false;
+    }
+    std::free(ms);
+    std::free(mb);
+    ++tests;
+
+#endif
+#if SCANF_USE_INTERN
+    /* %y should give the same string the same ID, and merging should map
+       the IDs of one dictionary to those of the other */
+    struct scanf_dict_ dict, dict2;
+    unsigned y1, y2, y3, ymap[2];
+    std::size_t ylen;
+    test::scanf_dict_init_(&dict);
+    test::scanf_dict_init_(&dict2);
+    if (3 != test::sscanf_("GET /a GET:x", "%y %*s %y[A-Z]:%y", &dict, &y1,
+                           &dict, &y2, &dict, &y3)
+            || y1 != 0 || y2 != 0 || y3 != 1 || dict.count != 2
+            || std::strcmp(test::scanf_dict_get_(&dict, 1, &ylen), "x")
+            || ylen != 1 || test::scanf_dict_get_(&dict, 2, NULL)
+            || test::scanf_dict_intern_(&dict2, "x", 1, &y1)
+            || test::scanf_dict_intern_(&dict2, "POST", 4, &y2)
+            || test::scanf_dict_merge_(&dict, &dict2, ymap)
+            || ymap[0] != 1 || ymap[1] != 2 || dict.count != 3) {
+        std::cout << "%y!" << std::endl;
+        return false;
+    }
+    test::scanf_dict_free_(&dict);
+    test::scanf_dict_free_(&dict2);
+    ++tests;
+
+#endif
+#if SCANF_KEYWORDS
+    /* %{...}e should store the index of the keyword, reading no more than
+       any keyword goes on, and fail on anything else */
+    const char *kf = "%{GET|POST|PUT|DELETE}e %{GETS|G}e%n";
+    int kw1 = -1, kw2 = -1, kn = 0;
+    if (2 != test::sscanf_(" PUT GETSX", kf, &kw1, &kw2, &kn)
+            || kw1 != 2 || kw2 != 0 || kn != 9
+            || 0 != test::sscanf_("PUSH", kf, &kw1, &kw2, &kn)
+            || 1 != test::sscanf_("DELETE GE", kf, &kw1, &kw2, &kn)
+            || kw1 != 3 || 0 != test::sscanf_("x", "%{a|a}e", &kw1)
+            || 0 != test::sscanf_("x", "%{x}d", &kw1)
+            || 1 != test::sscanf_("xyz", "%2{x|xy|xyz}e", &kw1)
+            || kw1 != 1) {
+        std::cout << "%{...}e!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+    /* and stop before a character that no keyword goes on with, even if
+       it is in another keyword */
+    if (1 != test::sscanf_("PUTS", "%{GET|POST|PUT|DELETE}e%n", &kw1, &kn)
+            || kw1 != 2 || kn != 3
+            || 1 != test::sscanf_("ab", "%{a|bc}e%n", &kw1, &kn)
+            || kw1 != 0 || kn != 1
+            || 2 != test::sscanf_("POSTGET", "%{GET|POST}e%{GET|POST}e",
+                                  &kw1, &kw2)
+            || kw1 != 1 || kw2 != 0
+            || 0 != test::sscanf_("abx", "%{a|abc}e", &kw1)) {
+        std::cout << "%{...}e prefixes!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+#if SCANF_DECODE
+    /* %U and %Q should decode escapes as they copy, keeping broken ones */
+    char ub[16], qb[16];
+    if (2 != test::sscanf_("/a%20b%2g%4 x\\ty\\x41\\q\\x", "%U[^ ] %Qs", ub, qb)
+            || std::strcmp(ub, "/a b%2g%4") || std::strcmp(qb, "x\tyA\\q\\x")
+            || 1 != test::sscanf_("%41%42%43", "%6Us", ub)
+            || std::strcmp(ub, "AB") || 0 != test::sscanf_("a", "%Uc", ub)) {
+        std::cout << "%U/%Q!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+#endif
+    /* compiled formats should behave like the format strings */
+    union { std::size_t align; unsigned char b[1024]; } prog;
+    const char *pf = " x=%d,%3[a-z]%*s %n%c";
+    const char *ps = "  x=-42,abcdef  !", *psp = ps;
+    char buf4[4], c1, c2;
+    int j2, k2;
+    std::size_t plen = test::scanf_compile_(&prog, sizeof(prog), pf);
+    if (plen > sizeof(prog) || test::scanf_compile_(&prog, 8, pf) != plen
+            || 3 != test::sscanf_(ps, pf, &j, buf, &k, &c1)
+            || 3 != test::spscanf_exec_(&psp, &prog, &j2, buf4, &k2, &c2)
+            || j != j2 || k != k2 || c1 != c2 || std::strcmp(buf, buf4)
+            || psp != ps + 17
+            || test::sscanf_("%", pf, &j, buf, &k, &c1)
+                != test::sscanf_exec_("%", &prog, &j, buf, &k, &c1)) {
+        std::cout << "compiled format!" << std::endl;
+        return false;
+    }
+    ++tests;
+
+    /* a repeated format should hit the cache, if there is one */
+    unsigned long hits0, misses0, hits1, misses1;
+    test::scanf_cache_stats_(&hits0, &misses0);
+    for (int n = 0; n < 2; ++n) {
+        if (1 != test::sscanf_("17", "%d;", &j) || j != 17) {
+            std::cout << "cached format!" << std::endl;
+            return false;
+        }
+    }
+    test::scanf_cache_stats_(&hits1, &misses1);
+    if (SCANF_FORMAT_CACHE ? hits1 - hits0 < 1 || hits1 + misses1 - hits0
+                                                  - misses0 != 2
+                           : hits1 || misses1) {
+        std::cout << "format cache counters!" << std::endl;
+        return false;
+    }
+    ++tests;
+
     std::cout << "==========\n"
                  "  ALL OK  \n"
                  "==========" << std::endl;
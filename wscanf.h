@@ -50,35 +50,117 @@ extern "C" {
 #define ATTR_wscanf     __attribute__ ((format (scanf, 1, 2)))
 #define ATTR_swscanf    __attribute__ ((format (scanf, 2, 3)))
 #define ATTR_spwscanf   __attribute__ ((format (scanf, 2, 3)))
+#define ATTR_snwscanf   __attribute__ ((format (scanf, 3, 4)))
+#define ATTR_spnwscanf  __attribute__ ((format (scanf, 3, 4)))
 #define ATTR_fctwscanf  __attribute__ ((format (scanf, 4, 5)))
+#define ATTR_bufwscanf  __attribute__ ((format (scanf, 4, 5)))
 #define ATTR_vwscanf    __attribute__ ((format (scanf, 1, 0)))
 #define ATTR_vswscanf   __attribute__ ((format (scanf, 2, 0)))
 #define ATTR_vspwscanf  __attribute__ ((format (scanf, 2, 0)))
+#define ATTR_vsnwscanf  __attribute__ ((format (scanf, 3, 0)))
+#define ATTR_vspnwscanf __attribute__ ((format (scanf, 3, 0)))
 #define ATTR_vfctwscanf __attribute__ ((format (scanf, 4, 0)))
+#define ATTR_vbufwscanf __attribute__ ((format (scanf, 4, 0)))
 #else
 #define ATTR_wscanf
 #define ATTR_swscanf
 #define ATTR_spwscanf
+#define ATTR_snwscanf
+#define ATTR_spnwscanf
 #define ATTR_fctwscanf
+#define ATTR_bufwscanf
 #define ATTR_vwscanf
 #define ATTR_vswscanf
 #define ATTR_vspwscanf
+#define ATTR_vsnwscanf
+#define ATTR_vspnwscanf
 #define ATTR_vfctwscanf
+#define ATTR_vbufwscanf
 #endif
 
 ATTR_wscanf int wscanf_(const WCHAR *format, ...);
 ATTR_swscanf int swscanf_(const WCHAR *s, const WCHAR *format, ...);
 ATTR_spwscanf int spwscanf_(const WCHAR **sp, const WCHAR *format, ...);
+ATTR_snwscanf int snwscanf_(const WCHAR *s, size_t n,
+                            const WCHAR *format, ...);
+ATTR_spnwscanf int spnwscanf_(const WCHAR **sp, size_t *n,
+                              const WCHAR *format, ...);
 ATTR_fctwscanf int fctwscanf_(WINT (*getwch)(void *data),
                          void (*ungetwch)(WINT c, void *data),
                          void *data, const wchar_t *format, ...);
+ATTR_bufwscanf int bufwscanf_(size_t (*refill)(const WCHAR **buf, void *data),
+                              void (*consume)(size_t n, void *data),
+                              void *data, const WCHAR *format, ...);
 
 ATTR_vwscanf int vwscanf_(const WCHAR *format, va_list arg);
 ATTR_vswscanf int vswscanf_(const WCHAR *s, const WCHAR *format, va_list arg);
 ATTR_vspwscanf int vspwscanf_(const WCHAR **sp, const WCHAR *format, va_list arg);
+ATTR_vsnwscanf int vsnwscanf_(const WCHAR *s, size_t n, const WCHAR *format,
+                              va_list arg);
+ATTR_vspnwscanf int vspnwscanf_(const WCHAR **sp, size_t *n,
+                                const WCHAR *format, va_list arg);
 ATTR_vfctwscanf int vfctwscanf_(WINT (*getwch)(void *data),
                               void (*ungetwch)(WINT c, void *data),
                               void *data, const WCHAR *format, va_list arg);
+ATTR_vbufwscanf int vbufwscanf_(size_t (*refill)(const WCHAR **buf, void *data),
+                                void (*consume)(size_t n, void *data),
+                                void *data, const WCHAR *format, va_list arg);
+
+/* compiled formats */
+size_t wscanf_compile_(void *buf, size_t size, const WCHAR *format);
+int wscanf_exec_(const void *prog, ...);
+int swscanf_exec_(const WCHAR *s, const void *prog, ...);
+int spwscanf_exec_(const WCHAR **sp, const void *prog, ...);
+int vwscanf_exec_(const void *prog, va_list arg);
+int vswscanf_exec_(const WCHAR *s, const void *prog, va_list arg);
+int vspwscanf_exec_(const WCHAR **sp, const void *prog, va_list arg);
+
+/* format cache */
+void wscanf_cache_stats_(unsigned long *hits, unsigned long *misses);
+
+/* allocator for %ms, %m[ and %mc on the current thread: resizes p (NULL
+   for a new block) from oldsize to size bytes, frees it if size is 0, and
+   returns the new block or NULL if it cannot. NULL sets the default */
+void scanf_set_allocator_(void *(*resize)(void *data, void *p,
+                                          size_t oldsize, size_t size),
+                          void *data);
+
+/* a string read in place by %v or %v[, valid for as long as the input is */
+struct wscanf_view_ {
+    const WCHAR *ptr;
+    size_t len;
+};
+
+/* where %k, %k[ and %kc send what they read: write is called with the data
+   and each chunk of the field, and returns nonzero to stop reading it */
+struct wscanf_sink_ {
+    int (*write)(void *data, const WCHAR *p, size_t n);
+    void *data;
+};
+
+/* a dictionary for %y and %y[, which give every distinct string read into it
+   an ID, counting from 0. the strings are kept one after the other, each
+   terminated, in text; offs[id] is where each starts. only the dictionary
+   functions should change it. it uses the allocator of the thread that set
+   it up, and the same one may not be used by two threads at once */
+struct wscanf_dict_ {
+    unsigned count;
+    WCHAR *text;
+    size_t *offs;
+    unsigned *table;
+    size_t textlen, textcap, offscap, tablecap;
+    void *(*resize)(void *data, void *p, size_t oldsize, size_t size);
+    void *data;
+};
+
+void wscanf_dict_init_(struct wscanf_dict_ *d);
+void wscanf_dict_free_(struct wscanf_dict_ *d);
+int wscanf_dict_intern_(struct wscanf_dict_ *d, const WCHAR *s, size_t n,
+                         unsigned *id);
+const WCHAR *wscanf_dict_get_(const struct wscanf_dict_ *d, unsigned id,
+                              size_t *n);
+int wscanf_dict_merge_(struct wscanf_dict_ *d,
+                       const struct wscanf_dict_ *from, unsigned *map);
 
 WINT getwch_(void);
 void ungetwch_(WINT);
@@ -97,9 +179,32 @@ size_t wcrtomb_(char *s, WCHAR wc, scanf_mbstate_t *ps);
 #endif
 
 #define spwscanf spwscanf_
+#define snwscanf snwscanf_
+#define spnwscanf spnwscanf_
 #define fctwscanf fctwscanf_
 #define vspwscanf vspwscanf_
+#define vsnwscanf vsnwscanf_
+#define vspnwscanf vspnwscanf_
 #define vfctwscanf vfctwscanf_
+#define bufwscanf bufwscanf_
+#define vbufwscanf vbufwscanf_
+#define wscanf_compile wscanf_compile_
+#define wscanf_exec wscanf_exec_
+#define swscanf_exec swscanf_exec_
+#define spwscanf_exec spwscanf_exec_
+#define vwscanf_exec vwscanf_exec_
+#define vswscanf_exec vswscanf_exec_
+#define vspwscanf_exec vspwscanf_exec_
+#define wscanf_cache_stats wscanf_cache_stats_
+#define wscanf_view wscanf_view_
+#define wscanf_sink wscanf_sink_
+#define wscanf_dict wscanf_dict_
+#define wscanf_dict_init wscanf_dict_init_
+#define wscanf_dict_free wscanf_dict_free_
+#define wscanf_dict_intern wscanf_dict_intern_
+#define wscanf_dict_get wscanf_dict_get_
+#define wscanf_dict_merge wscanf_dict_merge_
+#define scanf_set_allocator scanf_set_allocator_
 #endif
 
 #ifdef __cplusplus